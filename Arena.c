@@ -0,0 +1,86 @@
+#include "Arena.h"
+
+
+/* Rounds a size up to a multiple of ARENA_ALIGN */
+#define ARENA_ROUND( size ) ( ( ( size ) + ARENA_ALIGN - 1 ) & ~(size_t)( ARENA_ALIGN - 1 ) )
+/* The space taken by a chunk's header */
+#define ARENA_HEADER ARENA_ROUND( sizeof( struct arenaChunk ) )
+
+
+#ifdef SIM_STATS
+_Thread_local long simAllocs = 0;
+#endif
+
+
+Arena arenaCreate( size_t chunkSize )
+{
+	Arena newArena;
+
+	newArena = malloc( sizeof *newArena );
+	SIM_STAT( simAllocs++; )
+	newArena->head = NULL;
+	newArena->chunkSize = ( chunkSize > 0 ) ? ARENA_ROUND( chunkSize ) : ARENA_CHUNK_SIZE;
+
+	return newArena;
+}
+
+
+/****
+ *  arenaFreeChunks
+ *  Description: Frees a chain of chunks.
+ *
+ *  struct arenaChunk *chunk - The first chunk of the chain. May be null.
+ *
+ *  Returns nothing.
+ */
+static void arenaFreeChunks( struct arenaChunk *chunk )
+{
+	while( chunk != NULL )
+	{
+		struct arenaChunk *next = chunk->next;
+
+		free( chunk );
+		chunk = next;
+	}
+}
+
+
+void arenaDestroy( Arena arena )
+{
+	assert( arena != NULL );
+
+	arenaFreeChunks( arena->head );
+	free( arena );
+}
+
+
+void *arenaAlloc( Arena arena, size_t size )
+{
+	struct arenaChunk *chunk;
+	void *mem;
+
+	assert( arena != NULL );
+
+	chunk = arena->head;
+	size = ARENA_ROUND( size );
+
+	/* Start a new chunk if this one is full. An allocation bigger than a
+	 * chunk gets a chunk of its own */
+	if( chunk == NULL || chunk->size - chunk->used < size )
+	{
+		size_t chunkSize = ( size > arena->chunkSize ) ? size : arena->chunkSize;
+
+		chunk = malloc( ARENA_HEADER + chunkSize );
+		SIM_STAT( simAllocs++; )
+		chunk->next = arena->head;
+		chunk->size = chunkSize;
+		chunk->used = 0;
+		arena->head = chunk;
+	}
+
+	mem = (char *)chunk + ARENA_HEADER + chunk->used;
+	chunk->used += size;
+
+	return mem;
+}
+
@@ -0,0 +1,89 @@
+/* Arena.h
+ * A region allocator. Memory is handed out by
+ * bumping a pointer through large chunks, and is
+ * only ever given back all at once when the arena
+ * is destroyed. Each owner keeps its own
+ * arena, so threads that each own their arenas
+ * never contend with each other or on the heap.
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stdlib.h>
+#include "common.h"
+
+/* Every allocation is aligned to this many bytes, which is enough for any
+ * of the types in the program */
+#define ARENA_ALIGN 16
+/* The default number of bytes in a chunk */
+#define ARENA_CHUNK_SIZE 65536
+
+
+/* A chunk of memory that allocations are carved from. The memory follows
+ * the header, starting at the next multiple of ARENA_ALIGN.
+ * next - The chunk that was in use before this one, or NULL.
+ * size - The number of bytes of memory in the chunk.
+ * used - The number of bytes handed out so far. */
+struct arenaChunk
+{
+	struct arenaChunk *next;
+	size_t size;
+	size_t used;
+};
+
+
+/* A structure to represent an arena. head is the chunk currently being
+ * allocated from, and the other chunks are chained behind it. chunkSize is
+ * the size of each new chunk. */
+typedef struct Arena
+{
+	struct arenaChunk *head;
+	size_t chunkSize;
+} *Arena;
+
+
+/* CREATION/DESTRUCTION */
+
+/****
+ *  arenaCreate
+ *  Description: Creates an empty arena. No chunk is allocated until the
+ *  	first allocation.
+ *
+ *  size_t chunkSize - The number of bytes to allocate at a time. Zero means
+ *  	ARENA_CHUNK_SIZE.
+ *
+ *  Returns a new arena. This should be freed with arenaDestroy.
+ */
+Arena arenaCreate( size_t chunkSize );
+
+
+/****
+ *  arenaDestroy
+ *  Description: Destroys an arena and everything allocated from it. The time
+ *  	taken depends on the number of chunks, not the number of allocations.
+ *
+ *  Arena arena - The arena to destroy. Must be non-null.
+ *
+ *  Returns nothing.
+ */
+void arenaDestroy( Arena arena );
+
+
+/* ALLOCATION */
+
+/****
+ *  arenaAlloc
+ *  Description: Allocates memory from an arena. It can not be freed on its
+ *  	own.
+ *
+ *  Arena arena - The arena to allocate from. Must be non-null.
+ *  size_t size - The number of bytes wanted.
+ *
+ *  Returns a pointer to size bytes aligned to ARENA_ALIGN. It is valid until
+ *  	the arena is destroyed.
+ */
+void *arenaAlloc( Arena arena, size_t size );
+
+
+#endif
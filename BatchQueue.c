@@ -0,0 +1,162 @@
+#include "BatchQueue.h"
+
+
+BatchQueue batchQueueCreate( size_t capacity )
+{
+	BatchQueue newQueue;
+
+	assert( capacity > 0 );
+
+	newQueue = malloc( sizeof *newQueue );
+	if( pthread_mutex_init( &newQueue->lock, NULL ) != 0 )
+	{
+		free( newQueue );
+		newQueue = NULL;
+	}
+	else if( pthread_cond_init( &newQueue->notEmpty, NULL ) != 0 )
+	{
+		pthread_mutex_destroy( &newQueue->lock );
+		free( newQueue );
+		newQueue = NULL;
+	}
+	else if( pthread_cond_init( &newQueue->notFull, NULL ) != 0 )
+	{
+		pthread_cond_destroy( &newQueue->notEmpty );
+		pthread_mutex_destroy( &newQueue->lock );
+		free( newQueue );
+		newQueue = NULL;
+	}
+	else
+	{
+		newQueue->items = malloc( capacity * sizeof *newQueue->items );
+		newQueue->head = 0;
+		newQueue->count = 0;
+		newQueue->capacity = capacity;
+		newQueue->closed = FALSE;
+		newQueue->loading = 0;
+	}
+
+	return newQueue;
+}
+
+
+void batchQueueDestroy( BatchQueue queue )
+{
+	assert( queue != NULL && queue->count == 0 && queue->loading == 0 );
+
+	pthread_cond_destroy( &queue->notFull );
+	pthread_cond_destroy( &queue->notEmpty );
+	pthread_mutex_destroy( &queue->lock );
+	free( queue->items );
+	free( queue );
+}
+
+
+void batchQueuePush( BatchQueue queue, const struct batchJob *job )
+{
+	assert( queue != NULL );
+	assert( job != NULL );
+
+	pthread_mutex_lock( &queue->lock );
+	assert( !queue->closed );
+	/* Need to loop to prevent spurious wakeups */
+	while( queue->count == queue->capacity )
+	{
+		pthread_cond_wait( &queue->notFull, &queue->lock );
+	}
+	queue->items[( queue->head + queue->count ) % queue->capacity] = *job;
+	queue->count++;
+	pthread_mutex_unlock( &queue->lock );
+
+	/* Only one worker can take the job, so only wake one */
+	pthread_cond_signal( &queue->notEmpty );
+}
+
+
+int batchQueueTryPush( BatchQueue queue, const struct batchJob *job )
+{
+	int added;
+
+	assert( queue != NULL );
+	assert( job != NULL );
+
+	pthread_mutex_lock( &queue->lock );
+	assert( !queue->closed || queue->loading > 0 );
+	added = ( queue->count < queue->capacity );
+	if( added )
+	{
+		queue->items[( queue->head + queue->count ) % queue->capacity] = *job;
+		queue->count++;
+	}
+	pthread_mutex_unlock( &queue->lock );
+
+	if( added )
+	{
+		pthread_cond_signal( &queue->notEmpty );
+	}
+
+	return added;
+}
+
+
+int batchQueuePop( BatchQueue queue, struct batchJob *outJob )
+{
+	int found;
+
+	assert( queue != NULL );
+	assert( outJob != NULL );
+
+	pthread_mutex_lock( &queue->lock );
+	/* A load under way may yet add jobs, so the queue is not finished
+	 * until it is done */
+	while( queue->count == 0 && ( !queue->closed || queue->loading > 0 ) )
+	{
+		pthread_cond_wait( &queue->notEmpty, &queue->lock );
+	}
+	found = ( queue->count > 0 );
+	if( found )
+	{
+		*outJob = queue->items[queue->head];
+		queue->head = ( queue->head + 1 ) % queue->capacity;
+		queue->count--;
+		if( outJob->workload == NULL )
+		{
+			queue->loading++;
+		}
+	}
+	pthread_mutex_unlock( &queue->lock );
+
+	if( found )
+	{
+		pthread_cond_signal( &queue->notFull );
+	}
+
+	return found;
+}
+
+
+void batchQueueLoaded( BatchQueue queue )
+{
+	assert( queue != NULL );
+
+	pthread_mutex_lock( &queue->lock );
+	assert( queue->loading > 0 );
+	queue->loading--;
+	pthread_mutex_unlock( &queue->lock );
+
+	/* Workers waiting on the load may now be able to finish */
+	pthread_cond_broadcast( &queue->notEmpty );
+}
+
+
+void batchQueueClose( BatchQueue queue )
+{
+	assert( queue != NULL );
+
+	pthread_mutex_lock( &queue->lock );
+	queue->closed = TRUE;
+	pthread_mutex_unlock( &queue->lock );
+
+	/* Every waiting worker needs to find out */
+	pthread_cond_broadcast( &queue->notEmpty );
+}
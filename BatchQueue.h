@@ -0,0 +1,152 @@
+/* BatchQueue.h
+ * A bounded, blocking queue of simulation jobs to
+ * be shared between threads. A feeder thread adds
+ * jobs and blocks while the queue is full, so a
+ * batch of any size is held in a fixed amount of
+ * memory. Worker threads take jobs and block while
+ * the queue is empty, until it is closed.
+ */
+
+#ifndef BATCHQUEUE_H
+#define BATCHQUEUE_H
+
+#include <stdlib.h>
+#include <pthread.h>
+#include "common.h"
+#include "Workload.h"
+
+
+/* A job for a worker thread: run one algorithm on one workload.
+ * workload - The workload. The job holds one reference to it, which
+ * 	whoever takes the job must release. NULL if the workload has still to
+ * 	be loaded, in which case whoever takes the job loads it and may add
+ * 	jobs for the other algorithms.
+ * fileName - The file to load, for a job whose workload is NULL. Whoever
+ * 	takes the job must free it.
+ * algorithm - Which algorithm to run. The meaning is up to the user of the
+ * 	queue. */
+struct batchJob
+{
+	Workload workload;
+	char *fileName;
+	int algorithm;
+};
+
+
+/* A structure to represent the queue. items is a ring buffer of capacity
+ * jobs. The count jobs starting at items[head] (wrapping around the end of
+ * the buffer) are in the queue, oldest first. closed is set once the feeder
+ * will add no more jobs. loading is the number of jobs taken to be loaded
+ * that may still add jobs, so workers keep waiting for them even once the
+ * queue is closed. lock must be held to use any of the other fields.
+ * notEmpty and notFull are signalled when a job is added or taken. */
+typedef struct BatchQueue
+{
+	struct batchJob *items;
+	size_t head;
+	size_t count;
+	size_t capacity;
+	int closed;
+	size_t loading;
+	pthread_mutex_t lock;
+	pthread_cond_t notEmpty;
+	pthread_cond_t notFull;
+} *BatchQueue;
+
+
+/* CREATION/DESTRUCTION */
+
+/****
+ *  batchQueueCreate
+ *  Description: Creates an empty, open queue.
+ *
+ *  size_t capacity - The most jobs the queue can hold. Must be positive.
+ *
+ *  Returns a new queue, or NULL if its mutex or condition variables could
+ *  	not be created. This should be freed with batchQueueDestroy.
+ */
+BatchQueue batchQueueCreate( size_t capacity );
+
+
+/****
+ *  batchQueueDestroy
+ *  Description: Destroys a queue. No thread may be using it.
+ *
+ *  BatchQueue queue - The queue to destroy. Must be non-null and empty.
+ *
+ *  Returns nothing.
+ */
+void batchQueueDestroy( BatchQueue queue );
+
+
+/* QUEUE ACCESS */
+
+/****
+ *  batchQueuePush
+ *  Description: Adds a job to the back of the queue, waiting for room if
+ *  	the queue is full.
+ *
+ *  BatchQueue queue - The queue. Must be non-null and open.
+ *  const struct batchJob *job - The job to copy in to the queue.
+ *
+ *  Returns nothing.
+ */
+void batchQueuePush( BatchQueue queue, const struct batchJob *job );
+
+
+/****
+ *  batchQueueTryPush
+ *  Description: Adds a job to the back of the queue if there is room, for
+ *  	a worker that has loaded a workload. A worker never waits for room,
+ *  	as every worker might be waiting at once with no one left to make it.
+ *
+ *  BatchQueue queue - The queue. Must be non-null, and either open or
+ *  	waiting on a load taken by the caller.
+ *  const struct batchJob *job - The job to copy in to the queue.
+ *
+ *  Returns TRUE if the job was added, FALSE if the queue was full.
+ */
+int batchQueueTryPush( BatchQueue queue, const struct batchJob *job );
+
+
+/****
+ *  batchQueuePop
+ *  Description: Takes the job at the front of the queue, waiting for one if
+ *  	the queue is empty and still open or a load is still under way. A
+ *  	job with a NULL workload counts as a load until batchQueueLoaded is
+ *  	called for it.
+ *
+ *  BatchQueue queue - The queue. Must be non-null.
+ *  struct batchJob *outJob - Where to copy the job.
+ *
+ *  Returns TRUE if a job was taken, FALSE if the queue is closed, empty and
+ *  	no load is under way.
+ */
+int batchQueuePop( BatchQueue queue, struct batchJob *outJob );
+
+
+/****
+ *  batchQueueLoaded
+ *  Description: Marks a load taken from the queue as having added all of
+ *  	the jobs it is going to.
+ *
+ *  BatchQueue queue - The queue. Must be non-null.
+ *
+ *  Returns nothing.
+ */
+void batchQueueLoaded( BatchQueue queue );
+
+
+/****
+ *  batchQueueClose
+ *  Description: Marks the queue as having no more jobs coming. Workers
+ *  	finish the jobs already queued and are then told there are no more.
+ *
+ *  BatchQueue queue - The queue. Must be non-null.
+ *
+ *  Returns nothing.
+ */
+void batchQueueClose( BatchQueue queue );
+
+
+#endif
@@ -0,0 +1,258 @@
+#include <string.h>
+#include "Export.h"
+
+
+/* The longest a CSV row can be: every field at its longest with a comma or
+ * a newline after it */
+#define EXPORT_MAX_ROW ( EXPORT_NUM_COLUMNS * 21 )
+
+/* The names of the formats, in order of their EXPORT_ values */
+static const char *exportFormatNames[EXPORT_NUM_FORMATS] = { "csv", "bin" };
+
+/* The header row of a CSV export */
+static const char exportCsvHeader[] = "pNo,arrival,burst,first_run,response,completion,wait,turnaround,preemptions\n";
+
+
+/****
+ *  exportFlush
+ *  Description: Writes whatever is buffered to the file and empties the
+ *  	buffer. A binary block is written as its header and then each column.
+ *
+ *  Export export - The export.
+ *
+ *  Returns nothing. A failed write clears export->success.
+ */
+static void exportFlush( Export export )
+{
+	if( export->format == EXPORT_CSV )
+	{
+		if( export->bufLen > 0 && fwrite( export->buf, 1, export->bufLen, export->file ) != export->bufLen )
+		{
+			export->success = FALSE;
+		}
+		export->bufLen = 0;
+	}
+	else if( export->numRows > 0 )
+	{
+		struct exportBinBlock block;
+		int col;
+
+		memset( &block, 0, sizeof block );
+		block.rows = export->numRows;
+		if( fwrite( &block, sizeof block, 1, export->file ) != 1 )
+		{
+			export->success = FALSE;
+		}
+		for( col = 0; col < EXPORT_NUM_COLUMNS; col++ )
+		{
+			if( fwrite( export->columns + col * EXPORT_BLOCK_ROWS, sizeof *export->columns, export->numRows, export->file ) != export->numRows )
+			{
+				export->success = FALSE;
+			}
+		}
+		export->numRows = 0;
+	}
+}
+
+
+/****
+ *  exportWriteHeader
+ *  Description: Writes the header of a binary export at the current position
+ *  	of its file.
+ *
+ *  Export export - The export.
+ *
+ *  Returns TRUE if it was written.
+ */
+static int exportWriteHeader( Export export )
+{
+	struct exportBinHeader header;
+
+	memset( &header, 0, sizeof header );
+	memcpy( header.magic, EXPORT_BIN_MAGIC, sizeof header.magic );
+	header.version = EXPORT_BIN_VERSION;
+	header.numColumns = EXPORT_NUM_COLUMNS;
+	header.blockRows = EXPORT_BLOCK_ROWS;
+	header.count = export->count;
+
+	return fwrite( &header, sizeof header, 1, export->file ) == 1;
+}
+
+
+Export exportOpen( const char *outFileName, int format )
+{
+	Export newExport = NULL;
+	FILE *outFile;
+
+	assert( outFileName != NULL );
+	assert( format >= 0 && format < EXPORT_NUM_FORMATS );
+
+	outFile = fopen( outFileName, format == EXPORT_BIN ? "wb" : "w" );
+	if( outFile != NULL )
+	{
+		newExport = malloc( sizeof *newExport );
+		newExport->file = outFile;
+		newExport->format = format;
+		newExport->count = 0;
+		newExport->buf = NULL;
+		newExport->bufLen = 0;
+		newExport->columns = NULL;
+		newExport->numRows = 0;
+
+		/* The export does its own buffering, so stdio's would only copy
+		 * everything twice */
+		setvbuf( outFile, NULL, _IONBF, 0 );
+		if( format == EXPORT_CSV )
+		{
+			newExport->buf = malloc( EXPORT_BUF_SIZE );
+			newExport->success = ( fwrite( exportCsvHeader, 1, strlen( exportCsvHeader ), outFile ) == strlen( exportCsvHeader ) );
+		}
+		else
+		{
+			newExport->columns = malloc( EXPORT_NUM_COLUMNS * EXPORT_BLOCK_ROWS * sizeof *newExport->columns );
+			newExport->success = exportWriteHeader( newExport );
+		}
+	}
+
+	return newExport;
+}
+
+
+int exportClose( Export export )
+{
+	int success;
+
+	assert( export != NULL );
+
+	exportFlush( export );
+
+	/* Now the count is known it can go in the header. A file that can not
+	 * be gone back to keeps a count of zero */
+	if( export->format == EXPORT_BIN && export->success && fseek( export->file, 0, SEEK_SET ) == 0 )
+	{
+		export->success = exportWriteHeader( export );
+	}
+
+	/* A failed close means written data was lost */
+	success = ( fclose( export->file ) == 0 ) && export->success;
+	free( export->buf );
+	free( export->columns );
+	free( export );
+
+	return success;
+}
+
+
+/****
+ *  exportPutInt
+ *  Description: Writes an integer in decimal followed by a separator. This
+ *  	is done by hand as it is much quicker than a call to sprintf for every
+ *  	field.
+ *
+ *  char *pos - Where to write it. Must have room for 21 characters.
+ *  simTime value - The integer.
+ *  char sep - The character to write after it.
+ *
+ *  Returns the position after the separator.
+ */
+static char *exportPutInt( char *pos, simTime value, char sep )
+{
+	char digits[20];
+	int numDigits = 0;
+	/* Work with the magnitude as unsigned so the most negative value is
+	 * safe */
+	uint64_t mag = ( value < 0 ) ? 0u - (uint64_t)value : (uint64_t)value;
+
+	if( value < 0 )
+	{
+		*pos++ = '-';
+	}
+	do
+	{
+		digits[numDigits++] = '0' + mag % 10;
+		mag /= 10;
+	} while( mag > 0 );
+	while( numDigits > 0 )
+	{
+		*pos++ = digits[--numDigits];
+	}
+	*pos++ = sep;
+
+	return pos;
+}
+
+
+void exportAdd( Export export, const struct procResult *result )
+{
+	assert( export != NULL );
+	assert( result != NULL );
+
+	if( export->format == EXPORT_CSV )
+	{
+		char *pos;
+
+		if( EXPORT_BUF_SIZE - export->bufLen < EXPORT_MAX_ROW )
+		{
+			exportFlush( export );
+		}
+		pos = export->buf + export->bufLen;
+		pos = exportPutInt( pos, result->pNo, ',' );
+		pos = exportPutInt( pos, result->arrivalTime, ',' );
+		pos = exportPutInt( pos, result->burstTime, ',' );
+		pos = exportPutInt( pos, result->firstRun, ',' );
+		pos = exportPutInt( pos, result->response, ',' );
+		pos = exportPutInt( pos, result->completion, ',' );
+		pos = exportPutInt( pos, result->waitTime, ',' );
+		pos = exportPutInt( pos, result->turnTime, ',' );
+		pos = exportPutInt( pos, result->preemptions, '\n' );
+		export->bufLen = pos - export->buf;
+	}
+	else
+	{
+		int64_t *row = export->columns + export->numRows;
+
+		/* Each field goes in to its own column of the block */
+		row[0 * EXPORT_BLOCK_ROWS] = result->pNo;
+		row[1 * EXPORT_BLOCK_ROWS] = result->arrivalTime;
+		row[2 * EXPORT_BLOCK_ROWS] = result->burstTime;
+		row[3 * EXPORT_BLOCK_ROWS] = result->firstRun;
+		row[4 * EXPORT_BLOCK_ROWS] = result->response;
+		row[5 * EXPORT_BLOCK_ROWS] = result->completion;
+		row[6 * EXPORT_BLOCK_ROWS] = result->waitTime;
+		row[7 * EXPORT_BLOCK_ROWS] = result->turnTime;
+		row[8 * EXPORT_BLOCK_ROWS] = result->preemptions;
+		export->numRows++;
+		if( export->numRows == EXPORT_BLOCK_ROWS )
+		{
+			exportFlush( export );
+		}
+	}
+	export->count++;
+}
+
+
+int exportFormatFromName( const char *name )
+{
+	int format = -1;
+	int i;
+
+	assert( name != NULL );
+
+	for( i = 0; i < EXPORT_NUM_FORMATS; i++ )
+	{
+		if( strcmp( name, exportFormatNames[i] ) == 0 )
+		{
+			format = i;
+		}
+	}
+
+	return format;
+}
+
+
+const char *exportFormatName( int format )
+{
+	assert( format >= 0 && format < EXPORT_NUM_FORMATS );
+
+	return exportFormatNames[format];
+}
@@ -0,0 +1,173 @@
+/* Export.h
+ * Writes the result of every process of a
+ * simulation to a file as it completes, either as
+ * CSV or in a binary columnar format. Rows are
+ * gathered in a large buffer and written a buffer
+ * at a time, so exporting costs about what writing
+ * the bytes to disk does, however many processes
+ * there are.
+ */
+
+#ifndef EXPORT_H
+#define EXPORT_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include "common.h"
+
+/* The formats an export can be written in */
+#define EXPORT_CSV 0
+#define EXPORT_BIN 1
+#define EXPORT_NUM_FORMATS 2
+
+/* The binary export format. A file starts with a struct exportBinHeader,
+ * followed by blocks of up to EXPORT_BLOCK_ROWS processes. Each block is a
+ * struct exportBinBlock followed by EXPORT_NUM_COLUMNS columns of rows
+ * int64_t values each, in the order of the fields of struct procResult and
+ * in the byte order of the machine that wrote it. Processes are in the order
+ * they completed. */
+#define EXPORT_BIN_MAGIC "SCHEDRES"
+#define EXPORT_BIN_VERSION 2
+#define EXPORT_NUM_COLUMNS 9
+#define EXPORT_BLOCK_ROWS 65536
+
+/* The size of the buffer CSV rows are gathered in */
+#define EXPORT_BUF_SIZE ( 1 << 20 )
+
+
+/* The result of one process.
+ * pNo, arrivalTime, burstTime - As in struct proc.
+ * firstRun - When the process first ran.
+ * response - How long it waited to first run.
+ * completion - When it completed.
+ * waitTime - How long it spent in the ready queue in all.
+ * turnTime - How long it took from arriving to completing.
+ * preemptions - How many times it was stopped before completing. */
+struct procResult
+{
+	int64_t pNo;
+	simTime arrivalTime;
+	simTime burstTime;
+	simTime firstRun;
+	simTime response;
+	simTime completion;
+	simTime waitTime;
+	simTime turnTime;
+	int preemptions;
+};
+
+
+/* The header of a binary export file.
+ * magic - EXPORT_BIN_MAGIC, without its terminating null.
+ * version - EXPORT_BIN_VERSION.
+ * numColumns - EXPORT_NUM_COLUMNS.
+ * blockRows - The most rows in a block, EXPORT_BLOCK_ROWS.
+ * count - The number of processes in the file. Zero if the file could not
+ * 	be gone back to once it was written, in which case the blocks should be
+ * 	read until the end of the file. */
+struct exportBinHeader
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t numColumns;
+	uint32_t blockRows;
+	uint32_t reserved;
+	uint64_t count;
+};
+
+
+/* The start of a block of a binary export file.
+ * rows - The number of processes in the block. */
+struct exportBinBlock
+{
+	uint32_t rows;
+	uint32_t reserved;
+};
+
+
+/* A structure to represent an export.
+ * file - The file being written.
+ * format - EXPORT_CSV or EXPORT_BIN.
+ * count - The number of processes added so far.
+ * success - FALSE once a write has failed.
+ * buf, bufLen - The CSV text not yet written, for a CSV export.
+ * columns, numRows - The block not yet written, for a binary export. */
+typedef struct Export
+{
+	FILE *file;
+	int format;
+	size_t count;
+	int success;
+	char *buf;
+	size_t bufLen;
+	int64_t *columns;
+	size_t numRows;
+} *Export;
+
+
+/* CREATION/DESTRUCTION */
+
+/****
+ *  exportOpen
+ *  Description: Creates a file to export results to and writes its header.
+ *
+ *  const char *outFileName - The name of the file to create or overwrite.
+ *  int format - EXPORT_CSV or EXPORT_BIN.
+ *
+ *  Returns the new export, or NULL if the file could not be created. It
+ *  	should be finished with exportClose.
+ */
+Export exportOpen( const char *outFileName, int format );
+
+
+/****
+ *  exportClose
+ *  Description: Writes whatever is still buffered, closes the file and frees
+ *  	the export.
+ *
+ *  Export export - The export. Must be non-null.
+ *
+ *  Returns TRUE if everything was written.
+ */
+int exportClose( Export export );
+
+
+/* OPERATIONS */
+
+/****
+ *  exportAdd
+ *  Description: Adds the result of one process to an export.
+ *
+ *  Export export - The export. Must be non-null.
+ *  const struct procResult *result - The result. Must be non-null.
+ *
+ *  Returns nothing.
+ */
+void exportAdd( Export export, const struct procResult *result );
+
+
+/****
+ *  exportFormatFromName
+ *  Description: Looks up a format by name.
+ *
+ *  const char *name - "csv" or "bin".
+ *
+ *  Returns EXPORT_CSV or EXPORT_BIN, or -1 if the name is not known.
+ */
+int exportFormatFromName( const char *name );
+
+
+/****
+ *  exportFormatName
+ *  Description: The name of a format, which is also the extension used for
+ *  	its files.
+ *
+ *  int format - EXPORT_CSV or EXPORT_BIN.
+ *
+ *  Returns "csv" or "bin".
+ */
+const char *exportFormatName( int format );
+
+
+#endif
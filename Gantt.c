@@ -1,7 +1,22 @@
+#include <string.h>
 #include "Gantt.h"
 
 
-Gantt ganttCreate( int startTime )
+/* The number of ids the index has room for in a new chart */
+#define GANTT_INIT_INDEX 16
+
+
+/* A block as it is stored in the chart. The public part comes first so
+ * that a pointer to it can be handed out as a struct block *. nextById
+ * points to the next block with the same id, or NULL if there is none. */
+struct ganttBlock
+{
+	struct block block;
+	struct ganttBlock *nextById;
+};
+
+
+Gantt ganttCreate( simTime startTime )
 {
 	Gantt newGantt;
 
@@ -11,6 +26,13 @@ Gantt ganttCreate( int startTime )
 	newGantt->blockList = listCreate();
 	newGantt->startTime = startTime;
 
+	/* Start with an empty index that is grown as ids are added */
+	newGantt->idIndex = calloc( GANTT_INIT_INDEX, sizeof *newGantt->idIndex );
+	SIM_STAT( simAllocs += 2; )
+	newGantt->idIndexSize = GANTT_INIT_INDEX;
+	newGantt->cursor = NULL;
+	newGantt->cursorN = 0;
+
 	return newGantt;
 }
 
@@ -19,24 +41,76 @@ void ganttDestroy( Gantt inGantt )
 {
 	assert( inGantt != NULL );
 
-	/* Using listDestroyFree will free all of the
-	 * struct block * inside the list for us. */
-	listDestroyFree( inGantt->blockList );
+	/* The blocks all live in the list's arena, so destroying it
+	 * frees them without visiting each one */
+	listDestroy( inGantt->blockList );
+	free( inGantt->idIndex );
 	free( inGantt );
 }
 
 
+/****
+ *  ganttIndexBlock
+ *  Description: Adds a block to the end of the chain of blocks with its id,
+ *  	growing the index first if the id is beyond the end of it.
+ *
+ *  Gantt inGantt - The chart the block belongs to. Must be non-null.
+ *  struct ganttBlock *newBlock - The block to index. Its id must be
+ *  	non-negative.
+ *
+ *  Returns nothing.
+ */
+static void ganttIndexBlock( Gantt inGantt, struct ganttBlock *newBlock )
+{
+	struct ganttIdEntry *entry;
+	int64_t id = newBlock->block.id;
+	size_t maxSize = SIZE_MAX / sizeof *inGantt->idIndex;
+
+	/* An index with an entry for this id must fit in a size_t */
+	assert( (uint64_t)id < maxSize );
+
+	if( (uint64_t)id >= inGantt->idIndexSize )
+	{
+		size_t newSize = inGantt->idIndexSize;
+
+		/* Double the size, but never past what a size_t can count */
+		while( newSize <= (uint64_t)id && newSize < maxSize )
+		{
+			newSize = ( newSize <= maxSize / 2 ) ? newSize * 2 : maxSize;
+		}
+		inGantt->idIndex = realloc( inGantt->idIndex, newSize * sizeof *inGantt->idIndex );
+		SIM_STAT( simAllocs++; )
+		memset( inGantt->idIndex + inGantt->idIndexSize, 0,
+			( newSize - inGantt->idIndexSize ) * sizeof *inGantt->idIndex );
+		inGantt->idIndexSize = newSize;
+	}
+
+	entry = &inGantt->idIndex[id];
+	if( entry->count == 0 )
+	{
+		entry->first = newBlock;
+	}
+	else
+	{
+		entry->last->nextById = newBlock;
+	}
+	entry->last = newBlock;
+	entry->count++;
+}
+
+
 /* Always adds a block to the  end */
-void ganttAddBlock( Gantt inGantt, int id, int totalTime )
+void ganttAddBlock( Gantt inGantt, int64_t id, simTime totalTime )
 {
-	struct block *newBlock;
+	struct ganttBlock *newBlock;
 
 	assert( inGantt != NULL );
 	assert( totalTime >= 0 );
 
 	/* Create and initialise new block */
-	newBlock = malloc( sizeof *newBlock );
-	newBlock->id = id;
+	newBlock = listAlloc( inGantt->blockList, sizeof *newBlock );
+	newBlock->block.id = id;
+	newBlock->nextById = NULL;
 	
 	/* Find the appropriate start time for this new block */
 	if( listSize( inGantt->blockList ) != 0 )
@@ -45,76 +119,77 @@ void ganttAddBlock( Gantt inGantt, int id, int totalTime )
 
 		lastBlock = listGet( inGantt->blockList, listSize( inGantt->blockList ) );
 		/* The startTime is the same as the endTime of the previous block */
-		newBlock->startTime = lastBlock->endTime;
+		newBlock->block.startTime = lastBlock->endTime;
 	}
 	else
 	{
 		/* This is our first block. The start time is equal to the start
 		 * time of our gantt chart */
-		newBlock->startTime = inGantt->startTime;
+		newBlock->block.startTime = inGantt->startTime;
 	}
 
-	newBlock->endTime = newBlock->startTime + totalTime;
+	newBlock->block.endTime = newBlock->block.startTime + totalTime;
 
 	/* Add the new block to the END of our list */
 	listAdd( inGantt->blockList, newBlock, listSize( inGantt->blockList ) + 1 );
+
+	if( id >= 0 )
+	{
+		ganttIndexBlock( inGantt, newBlock );
+	}
 }
 
 
 
-int ganttNumBlocksById( Gantt inGantt, int id )
+int ganttNumBlocksById( Gantt inGantt, int64_t id )
 {
 	int numBlocks = 0;
-	int i;
 
 	assert( inGantt != NULL );
+	assert( id >= 0 );
 
-	if( listSize( inGantt->blockList ) != 0 )
+	/* Ids beyond the end of the index have never been added */
+	if( (uint64_t)id < inGantt->idIndexSize )
 	{
-		/* Loop through our list of blocks and compare block IDs with
-		 * id */ 
-		for( i = 1; i <= listSize( inGantt->blockList ); i++ )
-		{
-			struct block *curBlock;
-
-			curBlock = listGet( inGantt->blockList, i );
-			if( curBlock->id == id )
-			{
-				numBlocks++;
-			}
-		}
+		numBlocks = inGantt->idIndex[id].count;
 	}
 	
 	return numBlocks;
 }
 
 
-struct block *ganttGetBlockById( Gantt inGantt, int id, int n )
+struct block *ganttGetBlockById( Gantt inGantt, int64_t id, int n )
 {
-	int numBlocks = 0;
-	struct block *outBlock;
+	struct ganttIdEntry *entry;
+	struct ganttBlock *outBlock;
 	int i;
 
 	assert( 1 <= n && n <= ganttNumBlocksById( inGantt, id ) );
 
-	/* Loop through the entire list and increment numBlocks if
-	 * the block ID is equal to ids. Once numBlocks reaches n we will
-	 * have our desired block. */
-	i = 1;	
-	while( numBlocks < n )
+	entry = &inGantt->idIndex[id];
+	if( n == entry->count )
 	{
-		struct block *curBlock;
-
-		curBlock = listGet( inGantt->blockList, i );
-		if( curBlock->id == id )
+		outBlock = entry->last;
+	}
+	else if( n == inGantt->cursorN + 1 && inGantt->cursor != NULL && inGantt->cursor->block.id == id )
+	{
+		/* Carrying on from the block found last time */
+		outBlock = inGantt->cursor->nextById;
+	}
+	else
+	{
+		/* Walk along the chain of blocks with this id */
+		outBlock = entry->first;
+		for( i = 1; i < n; i++ )
 		{
-			numBlocks++;
-			outBlock = curBlock;
+			outBlock = outBlock->nextById;
 		}
-		i++;
 	}
 
-	return outBlock;
+	inGantt->cursor = outBlock;
+	inGantt->cursorN = n;
+
+	return &outBlock->block;
 }
 
 
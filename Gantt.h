@@ -40,9 +40,31 @@
  */
 struct block
 {
-	int id;
-	int startTime;
-	int endTime;
+	int64_t id;
+	simTime startTime;
+	simTime endTime;
+};
+
+
+/* The id reserved for a block during which nothing was scheduled. Gaps
+ * in a chart are filled with blocks of this id so that every other block
+ * keeps its true start time. */
+#define GANTT_IDLE -1
+
+/* The id reserved for a block during which the CPU was switching to the
+ * next process rather than running it. */
+#define GANTT_OVERHEAD -2
+
+
+/* An entry in a gantt chart's per-id index. Records the first and last
+ * block with a given id along with how many blocks have that id. The
+ * blocks with the same id are chained together in the order they were
+ * added, so they can be walked without looking at any other block. */
+struct ganttIdEntry
+{
+	struct ganttBlock *first;
+	struct ganttBlock *last;
+	int count;
 };
 
 
@@ -50,11 +72,21 @@ struct block
  * a collection of blocks (see above). For simplicity we have used a
  * linked list but any representation would do.
  * startTime is the startTime of the first block in the chart. This is set
- * to allow our gantt chart to start at a time other than 0.*/
+ * to allow our gantt chart to start at a time other than 0.
+ * idIndex is a table of idIndexSize entries, one for each id from 0 up,
+ * that is grown as larger ids are added.
+ * cursor and cursorN remember the last block found by id and its position
+ * among the blocks with that id, so that asking for the next one is O(1).
+ * The blocks themselves are allocated with listAlloc on blockList, so that
+ * a chart of any size is freed in a handful of calls to free.*/
 typedef struct Gantt
 {
 	LList blockList;
-	int startTime;
+	simTime startTime;
+	struct ganttIdEntry *idIndex;
+	size_t idIndexSize;
+	struct ganttBlock *cursor;
+	int cursorN;
 } *Gantt;
 
 
@@ -65,12 +97,12 @@ typedef struct Gantt
  *  ganttCreate
  *  Description: Creates an empty gantt chart.
  *
- *  int startTime - The start time of the first block in the gantt
+ *  simTime startTime - The start time of the first block in the gantt
  *  	chart. Note that the first block need not be added straight away.
  *  
  *  Returns a new empty Gantt chart.
  */
-Gantt ganttCreate( int startTime );
+Gantt ganttCreate( simTime startTime );
 
 
 /****
@@ -93,24 +125,28 @@ void ganttDestroy( Gantt inGantt );
  *  Description: Adds a new block of time to the end of the chart.
  *
  *  Gantt inGantt - The gantt chart to add the block to. Must be non-null.
- *  int id - The id of the new block.
- *  int totalTime - The total time allocated to the new block. Must be non-negative.
+ *  int64_t id - The id of the new block, usually a process number. Blocks
+ *  	with an id of zero or more are indexed so that they can be found by
+ *  	id. Negative ids, such as GANTT_IDLE, are not. The index has an entry
+ *  	for every id up to the largest, so ids should be dense.
+ *  simTime totalTime - The total time allocated to the new block. Must be non-negative.
  *
  *  Returns nothing.
  */
-void ganttAddBlock( Gantt inGantt, int id, int totalTime );
+void ganttAddBlock( Gantt inGantt, int64_t id, simTime totalTime );
 
 
 /****
  *  ganttNumBlocksById
  *  Description: Returns the number of blocks in the chart with the given id.
+ *  	This is O(1).
  *
  *  Gantt inGantt - The gantt chart to search. Must be non-null.
- *  int id  - The id to search for in the chart.
+ *  int64_t id  - The id to search for in the chart. Must be non-negative.
  *
  *  Returns the number of blocks found with the given id.
  */
-int ganttNumBlocksById( Gantt inGantt, int id );
+int ganttNumBlocksById( Gantt inGantt, int64_t id );
 
 
 /****
@@ -119,18 +155,20 @@ int ganttNumBlocksById( Gantt inGantt, int id );
  *  	ID of id. Can be viewed as taking the subset of blocks
  *  	with id of ID and then finding the nth member of that 
  *  	subset. Note that indexing of blocks is 1-based rather
- *  	than 0-based.
+ *  	than 0-based. The first and last blocks are found in O(1),
+ *  	as is the block after the one found by the previous call,
+ *  	so walking all k blocks with an id in order is O(k).
  *
  *  Gantt inGantt - The gantt chart to search. Must be non-null.
- *  int id - The id to search for. The id must be present somewhere
- *  	in the chart.
+ *  int64_t id - The id to search for. The id must be non-negative and
+ *  	present somewhere in the chart.
  *  int n - The index of the desired block. Must be between 1 and 
  *  	ganttNumBlocksById( inGantt, id ) inclusive.
  *
  *  Returns a struct block * that points to the desired block. This block
  *  should NOT be freed by the caller.
  */
-struct block *ganttGetBlockById( Gantt inGantt, int id, int n );
+struct block *ganttGetBlockById( Gantt inGantt, int64_t id, int n );
 
 
 /****
@@ -0,0 +1,276 @@
+#include <string.h>
+#include <math.h>
+#include "Generator.h"
+
+
+/* The names of the distributions, as used on the command line */
+static const char *genArrivalNames[GEN_NUM_ARRIVALS] = { "poisson", "mmpp" };
+static const char *genBurstNames[GEN_NUM_BURSTS] = { "exp", "bimodal", "pareto" };
+
+
+/****
+ *  genSeed
+ *  Description: Turns a seed in to the starting state of a generator with
+ *  	one step of splitmix64, so that nearby seeds give unrelated states.
+ *
+ *  uint64_t seed - The seed.
+ *
+ *  Returns a non-zero state.
+ */
+static uint64_t genSeed( uint64_t seed )
+{
+	uint64_t z = seed + 0x9e3779b97f4a7c15ULL;
+
+	z = ( z ^ ( z >> 30 ) ) * 0xbf58476d1ce4e5b9ULL;
+	z = ( z ^ ( z >> 27 ) ) * 0x94d049bb133111ebULL;
+	z = z ^ ( z >> 31 );
+
+	/* xorshift never leaves a zero state */
+	return z != 0 ? z : 1;
+}
+
+
+/****
+ *  genUniform
+ *  Description: Draws a uniform number with xorshift64*.
+ *
+ *  uint64_t *state - The generator's state.
+ *
+ *  Returns a number greater than 0 and no greater than 1, so its logarithm
+ *  	is always defined.
+ */
+static double genUniform( uint64_t *state )
+{
+	uint64_t x = *state;
+
+	x ^= x >> 12;
+	x ^= x << 25;
+	x ^= x >> 27;
+	*state = x;
+
+	return ( ( ( x * 0x2545f4914f6cdd1dULL ) >> 11 ) + 1 ) / 9007199254740992.0;
+}
+
+
+/* Draws from an exponential distribution with the given mean */
+static double genExp( uint64_t *state, double mean )
+{
+	return -mean * log( genUniform( state ) );
+}
+
+
+/****
+ *  genGeometricMean
+ *  Description: Bursts are whole ticks, drawn as 1 plus the whole part of an
+ *  	exponential. This finds the mean of the exponential that makes the
+ *  	mean of the bursts come out exactly.
+ *
+ *  double mean - The mean burst wanted.
+ *
+ *  Returns the mean of the exponential, 0 if every burst should be 1.
+ */
+static double genGeometricMean( double mean )
+{
+	return mean > 1.0 ? -1.0 / log( 1.0 - 1.0 / mean ) : 0.0;
+}
+
+
+Generator genCreate( const struct genConfig *config )
+{
+	Generator newGen;
+	double rate, shortMean;
+
+	assert( config != NULL );
+	assert( config->arrivals >= 0 && config->arrivals < GEN_NUM_ARRIVALS );
+	assert( config->bursts >= 0 && config->bursts < GEN_NUM_BURSTS );
+	assert( config->meanBurst >= 1.0 && config->utilisation > 0.0 );
+	assert( config->numCpus > 0 );
+	assert( config->burstiness >= 1.0 && config->dwell > 0.0 );
+	assert( config->paretoShape > 1.0 );
+
+	newGen = malloc( sizeof *newGen );
+	newGen->config = *config;
+
+	/* Little's law: the CPUs are busy utilisation of the time when work
+	 * arrives at utilisation * numCpus / meanBurst processes per tick. An
+	 * MMPP spends half its time at each level, so the two rates average
+	 * to the same */
+	rate = config->utilisation * config->numCpus / config->meanBurst;
+	if( config->arrivals == GEN_ARRIVE_MMPP )
+	{
+		newGen->rate[0] = 2.0 * rate * config->burstiness / ( config->burstiness + 1.0 );
+		newGen->rate[1] = 2.0 * rate / ( config->burstiness + 1.0 );
+	}
+	else
+	{
+		newGen->rate[0] = rate;
+		newGen->rate[1] = rate;
+	}
+	newGen->dwellMean = config->dwell / rate;
+
+	/* The long bimodal bursts are GEN_BIMODAL_RATIO times the short ones, so
+	 * the short mean is set to give the overall mean. Neither can be under
+	 * one tick */
+	shortMean = config->meanBurst / ( 1.0 - GEN_BIMODAL_LONG + GEN_BIMODAL_LONG * GEN_BIMODAL_RATIO );
+	if( shortMean < 1.0 )
+	{
+		shortMean = 1.0;
+	}
+	if( config->bursts == GEN_BURST_BIMODAL )
+	{
+		newGen->burstMean[0] = genGeometricMean( shortMean );
+		newGen->burstMean[1] = genGeometricMean( shortMean * GEN_BIMODAL_RATIO );
+	}
+	else
+	{
+		newGen->burstMean[0] = genGeometricMean( config->meanBurst );
+		newGen->burstMean[1] = newGen->burstMean[0];
+	}
+
+	/* Pareto bursts are rounded up, which adds half a tick on average */
+	newGen->paretoScale = ( config->meanBurst - 0.5 ) * ( config->paretoShape - 1.0 ) / config->paretoShape;
+
+	genRewind( newGen );
+
+	return newGen;
+}
+
+
+void genDestroy( Generator gen )
+{
+	assert( gen != NULL );
+
+	free( gen );
+}
+
+
+void genRewind( Generator gen )
+{
+	assert( gen != NULL );
+
+	/* The two generators are seeded apart so arrivals never depend on how
+	 * many bursts have been drawn */
+	gen->arrivalRng = genSeed( gen->config.seed );
+	gen->burstRng = genSeed( gen->config.seed ^ 0x5bd1e9955bd1e995ULL );
+	gen->clock = 0.0;
+	gen->level = genUniform( &gen->arrivalRng ) < 0.5 ? 0 : 1;
+	gen->levelEnd = genExp( &gen->arrivalRng, gen->dwellMean );
+}
+
+
+simTime genNextArrival( Generator gen )
+{
+	double gap;
+	simTime arrival = -1;
+
+	assert( gen != NULL );
+
+	gap = genExp( &gen->arrivalRng, 1.0 / gen->rate[gen->level] );
+
+	/* Gaps are memoryless, so when one would run past a change of level the
+	 * clock can stop at the change and draw afresh at the new rate */
+	while( gen->config.arrivals == GEN_ARRIVE_MMPP && gen->clock + gap > gen->levelEnd )
+	{
+		gen->clock = gen->levelEnd;
+		gen->level = 1 - gen->level;
+		gen->levelEnd = gen->clock + genExp( &gen->arrivalRng, gen->dwellMean );
+		gap = genExp( &gen->arrivalRng, 1.0 / gen->rate[gen->level] );
+	}
+	gen->clock += gap;
+
+	/* INT64_MAX rounds up to 2^63 as a double, so anything below it fits */
+	if( gen->clock < (double)INT64_MAX )
+	{
+		arrival = (simTime)gen->clock;
+	}
+
+	return arrival;
+}
+
+
+simTime genNextBurst( Generator gen )
+{
+	double burst;
+
+	assert( gen != NULL );
+
+	if( gen->config.bursts == GEN_BURST_PARETO )
+	{
+		burst = ceil( gen->paretoScale * pow( genUniform( &gen->burstRng ), -1.0 / gen->config.paretoShape ) );
+	}
+	else
+	{
+		int mode = 0;
+
+		if( gen->config.bursts == GEN_BURST_BIMODAL && genUniform( &gen->burstRng ) <= GEN_BIMODAL_LONG )
+		{
+			mode = 1;
+		}
+		burst = 1.0 + floor( genExp( &gen->burstRng, gen->burstMean[mode] ) );
+	}
+
+	if( burst < 1.0 )
+	{
+		burst = 1.0;
+	}
+	else if( burst > GEN_MAX_BURST )
+	{
+		burst = GEN_MAX_BURST;
+	}
+
+	return (simTime)burst;
+}
+
+
+const char *genArrivalName( int kind )
+{
+	assert( kind >= 0 && kind < GEN_NUM_ARRIVALS );
+
+	return genArrivalNames[kind];
+}
+
+
+const char *genBurstName( int kind )
+{
+	assert( kind >= 0 && kind < GEN_NUM_BURSTS );
+
+	return genBurstNames[kind];
+}
+
+
+int genArrivalFromName( const char *name )
+{
+	int kind = -1;
+	int i;
+
+	assert( name != NULL );
+
+	for( i = 0; i < GEN_NUM_ARRIVALS; i++ )
+	{
+		if( strcmp( name, genArrivalNames[i] ) == 0 )
+		{
+			kind = i;
+		}
+	}
+
+	return kind;
+}
+
+
+int genBurstFromName( const char *name )
+{
+	int kind = -1;
+	int i;
+
+	assert( name != NULL );
+
+	for( i = 0; i < GEN_NUM_BURSTS; i++ )
+	{
+		if( strcmp( name, genBurstNames[i] ) == 0 )
+		{
+			kind = i;
+		}
+	}
+
+	return kind;
+}
@@ -0,0 +1,193 @@
+/* Generator.h
+ * A source of synthetic processes. Arrival times
+ * come from a Poisson process, or from a two state
+ * Markov modulated Poisson process (MMPP) for bursty
+ * load, and burst times from an exponential, a
+ * bimodal or a heavy tailed Pareto distribution.
+ * The arrival rate is set from the mean burst so the
+ * CPUs are offered a chosen utilisation. Arrivals
+ * and bursts are drawn from separate generators
+ * seeded from one seed, so the same seed always
+ * gives the same workload and either column can be
+ * produced without the other.
+ */
+
+#ifndef GENERATOR_H
+#define GENERATOR_H
+
+#include <stdlib.h>
+#include <stdint.h>
+#include "common.h"
+
+/* How arrivals are spaced.
+ * GEN_ARRIVE_POISSON - Exponential gaps at a fixed rate.
+ * GEN_ARRIVE_MMPP - Exponential gaps at a rate that switches between a
+ * 	high and a low rate, spending an exponential time at each. */
+#define GEN_ARRIVE_POISSON 0
+#define GEN_ARRIVE_MMPP 1
+#define GEN_NUM_ARRIVALS 2
+
+/* How bursts are drawn.
+ * GEN_BURST_EXP - Exponential.
+ * GEN_BURST_BIMODAL - Mostly short exponential bursts with a few long ones,
+ * 	GEN_BIMODAL_RATIO times as long on average, mixed in.
+ * GEN_BURST_PARETO - Pareto, so a few bursts are very long. */
+#define GEN_BURST_EXP 0
+#define GEN_BURST_BIMODAL 1
+#define GEN_BURST_PARETO 2
+#define GEN_NUM_BURSTS 3
+
+/* The shape of the bimodal bursts: the fraction that are long, and how
+ * much longer they are on average */
+#define GEN_BIMODAL_LONG 0.1
+#define GEN_BIMODAL_RATIO 10.0
+
+/* Bursts are cut off here, so a Pareto tail can not overflow the clock */
+#define GEN_MAX_BURST 100000000
+
+
+/* The settings of a generator.
+ * arrivals - One of the GEN_ARRIVE_ values.
+ * bursts - One of the GEN_BURST_ values.
+ * meanBurst - The mean burst time. At least 1.
+ * utilisation - The fraction of the CPUs' time the bursts should fill.
+ * 	Positive.
+ * numCpus - The number of CPUs the workload is meant for. Positive.
+ * burstiness - For MMPP arrivals, how many times the high rate is the low
+ * 	rate. At least 1.
+ * dwell - For MMPP arrivals, the mean time spent at each rate, as a
+ * 	number of mean gaps between arrivals. Positive.
+ * paretoShape - For Pareto bursts, the shape. Greater than 1, and the
+ * 	closer to 1 the heavier the tail.
+ * seed - The seed. */
+struct genConfig
+{
+	int arrivals;
+	int bursts;
+	double meanBurst;
+	double utilisation;
+	int numCpus;
+	double burstiness;
+	double dwell;
+	double paretoShape;
+	uint64_t seed;
+};
+
+
+/* A structure to represent a generator.
+ * config - A copy of the settings.
+ * arrivalRng, burstRng - The states of the two random number generators.
+ * clock - The exact time of the last arrival.
+ * rate - The arrival rate at each MMPP level. Both the same for Poisson.
+ * level - The MMPP level in effect, 0 or 1.
+ * levelEnd - When the MMPP level next changes.
+ * dwellMean - The mean time spent at an MMPP level.
+ * burstMean - The mean of each bimodal mode, short then long, or of the
+ * 	exponential in burstMean[0]. Already adjusted for rounding.
+ * paretoScale - The smallest Pareto burst, before rounding up. */
+typedef struct Generator
+{
+	struct genConfig config;
+	uint64_t arrivalRng;
+	uint64_t burstRng;
+	double clock;
+	double rate[2];
+	int level;
+	double levelEnd;
+	double dwellMean;
+	double burstMean[2];
+	double paretoScale;
+} *Generator;
+
+
+/* CREATION/DESTRUCTION */
+
+/****
+ *  genCreate
+ *  Description: Creates a generator and rewinds it.
+ *
+ *  const struct genConfig *config - The settings. Must be non-null and
+ *  	within the ranges given above.
+ *
+ *  Returns the new generator. It should be freed with genDestroy.
+ */
+Generator genCreate( const struct genConfig *config );
+
+
+/****
+ *  genDestroy
+ *  Description: Frees a generator.
+ *
+ *  Generator gen - The generator. Must be non-null.
+ *
+ *  Returns nothing.
+ */
+void genDestroy( Generator gen );
+
+
+/* OPERATIONS */
+
+/****
+ *  genRewind
+ *  Description: Starts a generator over from its seed, so it hands out the
+ *  	same arrivals and bursts again.
+ *
+ *  Generator gen - The generator. Must be non-null.
+ *
+ *  Returns nothing.
+ */
+void genRewind( Generator gen );
+
+
+/****
+ *  genNextArrival
+ *  Description: Draws the next arrival time. Arrivals never go backwards,
+ *  	and the first is at or after 0.
+ *
+ *  Generator gen - The generator. Must be non-null.
+ *
+ *  Returns the arrival time in whole ticks, or -1 once the clock has passed
+ *  	the largest simTime.
+ */
+simTime genNextArrival( Generator gen );
+
+
+/****
+ *  genNextBurst
+ *  Description: Draws the next burst time.
+ *
+ *  Generator gen - The generator. Must be non-null.
+ *
+ *  Returns a burst time from 1 to GEN_MAX_BURST.
+ */
+simTime genNextBurst( Generator gen );
+
+
+/****
+ *  genArrivalName, genBurstName
+ *  Description: The name of an arrival or burst distribution, as used on the
+ *  	command line.
+ *
+ *  int kind - One of the GEN_ARRIVE_ or GEN_BURST_ values.
+ *
+ *  Returns "poisson" or "mmpp", and "exp", "bimodal" or "pareto".
+ */
+const char *genArrivalName( int kind );
+const char *genBurstName( int kind );
+
+
+/****
+ *  genArrivalFromName, genBurstFromName
+ *  Description: Looks up an arrival or burst distribution by name.
+ *
+ *  const char *name - One of the names given by genArrivalName or
+ *  	genBurstName.
+ *
+ *  Returns one of the GEN_ARRIVE_ or GEN_BURST_ values, or -1 if the name is
+ *  	not known.
+ */
+int genArrivalFromName( const char *name );
+int genBurstFromName( const char *name );
+
+
+#endif
@@ -1,14 +1,265 @@
+#include <string.h>
 #include "LList.h"
 
 
+/* The number of data pointers allocated for a new array backed list */
+#define LLIST_INIT_CAPACITY 16
+/* The number of nodes a linked list's pool makes room for at a time */
+#define LLIST_POOL_CHUNK 256
+/* The number of bytes of data listAlloc allocates at a time */
+#define LLIST_ARENA_CHUNK 65536
+
+
+#ifdef LLIST_ARRAY
+
+
+/****
+ *  listReserve
+ *  Description: Makes sure that there is room for one more data pointer
+ *  	after the last element of the list. Elements are first moved down to
+ *  	the start of the buffer if that frees up enough room, otherwise the
+ *  	buffer is doubled in size so that appends are amortised O(1).
+ *
+ *  LList list - The list to make room in. Must be non-null.
+ *
+ *  Returns nothing.
+ */
+static void listReserve( LList list )
+{
+	if( list->start + list->count == list->capacity )
+	{
+		if( list->start > list->capacity / 2 )
+		{
+			memmove( list->items, list->items + list->start, list->count * sizeof *list->items );
+			list->start = 0;
+		}
+		else
+		{
+			list->capacity *= 2;
+			list->items = realloc( list->items, list->capacity * sizeof *list->items );
+			SIM_STAT( simAllocs++; )
+		}
+	}
+}
+
+
+LList listCreate( void )
+{
+	LList newList;
+
+	/* Create list with a small empty buffer */
+	newList = malloc( sizeof *newList );
+
+	newList->items = malloc( LLIST_INIT_CAPACITY * sizeof *newList->items );
+	SIM_STAT( simAllocs += 2; )
+	newList->start = 0;
+	newList->capacity = LLIST_INIT_CAPACITY;
+	newList->dataArena = NULL;
+	newList->count = 0;
+
+	return newList;
+}
+
+
+/* A copied list should NOT be freed with listDestroyFree */
+LList listCopy( LList inList )
+{
+	LList outList;
+
+	assert( inList != NULL );
+
+	/* Create new list with just enough room and copy the data pointers
+	 * across in one go */
+	outList = malloc( sizeof *outList );
+	outList->capacity = inList->count > 0 ? inList->count : LLIST_INIT_CAPACITY;
+	outList->items = malloc( outList->capacity * sizeof *outList->items );
+	SIM_STAT( simAllocs += 2; )
+	memcpy( outList->items, inList->items + inList->start, inList->count * sizeof *outList->items );
+	outList->start = 0;
+	outList->dataArena = NULL;
+	outList->count = inList->count;
+
+	return outList;
+}
+
+
+void listDestroy( LList list )
+{
+	/* Not required to free data here, other than what lives in the
+	 * list's own arena. */
+	if( list->dataArena != NULL )
+	{
+		arenaDestroy( list->dataArena );
+	}
+	free( list->items );
+	free( list );
+}
+
+
+
+void listDestroyFree( LList list )
+{
+	size_t i;
+
+	/* Assuming that all data in the list is dynamically
+	 * allocated memory. Data from listAlloc goes with the arena. */
+	for( i = 0; list->dataArena == NULL && i < list->count; i++ )
+	{
+		free( list->items[list->start + i] );
+	}
+	listDestroy( list );
+}
+
+
+
+void listAdd( LList list, void *data, int position )
+{
+	void **newPos;
+
+	assert( 1 <= position && position <= list->count + 1 );
+
+	/* Adding to the head of a list whose head has been removed before
+	 * just reuses the free slot in front of it */
+	if( position == 1 && list->start > 0 )
+	{
+		list->start--;
+		list->items[list->start] = data;
+	}
+	else
+	{
+		/* Shift everything from 'position' onwards up by one. When
+		 * appending there is nothing to shift. */
+		listReserve( list );
+		newPos = list->items + list->start + position - 1;
+		memmove( newPos + 1, newPos, ( list->count - position + 1 ) * sizeof *newPos );
+		*newPos = data;
+	}
+	list->count++;
+}
+
+
+
+void *listGet( LList list, int position )
+{
+	assert( 1 <= position && position <= list->count );
+
+	return list->items[list->start + position - 1];
+}
+
+
+
+void *listRemove( LList list, int position )
+{
+	void **delPos;
+	void *data;
+
+	assert( 1 <= position && position <= list->count );
+
+	delPos = list->items + list->start + position - 1;
+	data = *delPos;
+
+	/* Removing the head just moves the start of the list along. Anywhere
+	 * else the succeeding elements are shifted down by one */
+	if( position == 1 )
+	{
+		list->start++;
+	}
+	else
+	{
+		memmove( delPos, delPos + 1, ( list->count - position ) * sizeof *delPos );
+	}
+	list->count--;
+
+	/* An empty list can start from the beginning of its buffer again */
+	if( list->count == 0 )
+	{
+		list->start = 0;
+	}
+
+	return data;
+}
+
+
+/* A bottom-up merge sort. Runs of width 1, 2, 4, ... are merged pairwise
+ * back and forth between the list's buffer and a single scratch buffer of
+ * the same size. When two elements are equal the one from the left run is
+ * taken first, so the sort is stable. */
+void listSort( LList list, int (*cmp)( const void *arg1, const void *arg2 ) )
+{
+	void **src, **dst, **tmp;
+	size_t width, lo;
+
+	assert( list != NULL );
+	assert( cmp != NULL );
+
+	if( list->count < 2 )
+	{
+		return;
+	}
+
+	src = list->items + list->start;
+	dst = malloc( list->count * sizeof *dst );
+	SIM_STAT( simAllocs++; )
+	tmp = dst;
+
+	for( width = 1; width < list->count; width *= 2 )
+	{
+		/* Merge each pair of neighbouring runs in src into dst */
+		for( lo = 0; lo < list->count; lo += 2 * width )
+		{
+			size_t mid, hi, l, r, out;
+
+			mid = lo + width < list->count ? lo + width : list->count;
+			hi = mid + width < list->count ? mid + width : list->count;
+			l = lo;
+			r = mid;
+			for( out = lo; out < hi; out++ )
+			{
+				if( r >= hi || ( l < mid && cmp( src[l], src[r] ) <= 0 ) )
+				{
+					dst[out] = src[l++];
+				}
+				else
+				{
+					dst[out] = src[r++];
+				}
+			}
+		}
+
+		/* The merged runs become the input to the next pass */
+		tmp = src;
+		src = dst;
+		dst = tmp;
+	}
+
+	/* After an odd number of passes the sorted data is in the scratch
+	 * buffer, which is then copied back */
+	if( src != list->items + list->start )
+	{
+		memcpy( list->items + list->start, src, list->count * sizeof *src );
+		free( src );
+	}
+	else
+	{
+		free( dst );
+	}
+}
+
+
+#else
+
+
 LList listCreate( void )
 {
 	LList newList;
 
 	/* Simply create list and initialise all to zero */
 	newList = malloc( sizeof *newList );
+	SIM_STAT( simAllocs++; )
 
 	newList->head = NULL;
+	newList->nodePool = poolCreate( sizeof( LLNode ), LLIST_POOL_CHUNK );
+	newList->dataArena = NULL;
 	newList->count = 0;
 
 	return newList;
@@ -37,11 +288,13 @@ LList listCopy( LList inList )
 
 void listDestroy( LList list )
 {
-	while( listSize( list ) > 0 )
+	/* Not required to free data here, other than what lives in the
+	 * list's own arena. The nodes all go at once with their pool */
+	if( list->dataArena != NULL )
 	{
-		/* Not required to free data here.*/
-		listRemove( list, 1 );
+		arenaDestroy( list->dataArena );
 	}
+	poolDestroy( list->nodePool );
 	free( list );
 }
 
@@ -49,13 +302,15 @@ void listDestroy( LList list )
 
 void listDestroyFree( LList list )
 {
-	while( listSize( list ) > 0 )
+	LLNode *curNode;
+
+	/* Assuming that all data in nodes is dynamically
+	 * allocated memory. Data from listAlloc goes with the arena. */
+	for( curNode = list->head; list->dataArena == NULL && curNode != NULL; curNode = curNode->next )
 	{
-		/* Assuming that all data in nodes is dynamically
-		 * allocated memory. */
-		free( listRemove( list, 1 ) );
+		free( curNode->data );
 	}
-	free( list );
+	listDestroy( list );
 }
 
 
@@ -70,7 +325,7 @@ void listAdd( LList list, void *data, int position )
 	assert( 1 <= position && position <= list->count + 1 );
 
 	/* Create new node */
-	newNode = malloc( sizeof *newNode );
+	newNode = poolAlloc( list->nodePool );
 	newNode->data = data;
 
 	/* Find node currently at 'position' and point new node at it */
@@ -131,49 +386,117 @@ void *listRemove( LList list, int position )
 	list->count--;
 
 	data = delNode->data;
-	free( delNode );
+	poolFree( list->nodePool, delNode );
 
 	return data;
 }
 
 
 
-size_t listSize( LList list )
+/****
+ *  listSplit
+ *  Description: Cuts a chain of nodes after its first n nodes.
+ *
+ *  LLNode *node - The first node of the chain. May be null.
+ *  size_t n - The number of nodes to keep in the first part. Must be at
+ *  	least 1.
+ *
+ *  Returns the first node of the second part, or NULL if the chain had no
+ *  	more than n nodes.
+ */
+static LLNode *listSplit( LLNode *node, size_t n )
 {
-	assert( list != NULL );
+	LLNode *rest = NULL;
 
-	return list->count;
+	/* Walk to the last node that is kept */
+	while( node != NULL && n > 1 )
+	{
+		node = node->next;
+		n--;
+	}
+	if( node != NULL )
+	{
+		rest = node->next;
+		node->next = NULL;
+	}
+
+	return rest;
 }
 
 
-/* A most inefficient yet simple list sorting algorithm. Essentially
- * a selection sort. Finds the max element in the subarray and places
- * it at the front of the list */
+/* A bottom-up merge sort that relinks the existing nodes, so nothing is
+ * allocated. Runs of width 1, 2, 4, ... are merged pairwise until a single
+ * run is left. When two elements are equal the one from the left run is
+ * taken first, so the sort is stable. */
 void listSort( LList list, int (*cmp)( const void *arg1, const void *arg2 ) )
 {
-	int maxIndex, subArrayStart;
-	int i;
+	size_t width;
 
 	assert( list != NULL );
 	assert( cmp != NULL );
 
-	/* Subarray will shrink by 1 each time as we move max element of subarray to
-	 * front of the list */
-	for( subArrayStart = 1; subArrayStart <= listSize( list ); subArrayStart++ )
+	for( width = 1; width < list->count; width *= 2 )
 	{
-		/* Loop through our subarray and find the max element */
-		maxIndex = subArrayStart;
-		for( i = subArrayStart + 1; i <= listSize( list ); i++ )
+		/* Double pointers are used again so that the first merged run
+		 * can be attached to the head just like any other */
+		LLNode *rest, **tail;
+
+		rest = list->head;
+		tail = &list->head;
+		while( rest != NULL )
 		{
-			if( cmp( listGet( list, maxIndex ), listGet( list, i ) ) <= 0 )
+			LLNode *left, *right;
+
+			/* Cut the next two runs off the front of the chain */
+			left = rest;
+			right = listSplit( left, width );
+			rest = listSplit( right, width );
+
+			/* Merge them on to the end of the sorted part */
+			while( left != NULL && right != NULL )
+			{
+				if( cmp( left->data, right->data ) <= 0 )
+				{
+					*tail = left;
+					left = left->next;
+				}
+				else
+				{
+					*tail = right;
+					right = right->next;
+				}
+				tail = &(*tail)->next;
+			}
+			*tail = left != NULL ? left : right;
+			while( *tail != NULL )
 			{
-				maxIndex = i;
+				tail = &(*tail)->next;
 			}
 		}
-		/* Max element found. Move it out of the subarray and to the start of
-		 * our list */
-		listAdd( list, listRemove( list, maxIndex ), 1 );
 	}
 }
 
 
+#endif
+
+
+void *listAlloc( LList list, size_t size )
+{
+	assert( list != NULL );
+
+	/* Lists that never hold their own data never make an arena */
+	if( list->dataArena == NULL )
+	{
+		list->dataArena = arenaCreate( LLIST_ARENA_CHUNK );
+	}
+
+	return arenaAlloc( list->dataArena, size );
+}
+
+
+size_t listSize( LList list )
+{
+	assert( list != NULL );
+
+	return list->count;
+}
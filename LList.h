@@ -2,6 +2,10 @@
  * A simple linked list implementation.
  * The nodes contain void pointers so as to allow
  * some degree of type genericity.
+ * There are two interchangeable backends behind the
+ * same functions. By default (LLIST_ARRAY in common.h) the
+ * list is stored in a contiguous, growable array. Otherwise
+ * it is a singly-linked chain of nodes.
  * The nodes in the list are indexed (where applicable)
  * starting at 1. This is important but highlights a conceptual
  * difference between lists and arrays.
@@ -14,6 +18,7 @@
 
 #include <stdlib.h>
 #include "common.h"
+#include "Pool.h"
 
 
 /* A structure to represent a single node of the list.
@@ -26,12 +31,27 @@ typedef struct LLNode
 } LLNode;
 
 
-/* A structure to represent a linked list. Contains a pointer to
- * the head of the list (NULL if list is empty) and a count of the
- * number of nodes (or the size) of the list.*/
+/* A structure to represent a linked list. Contains a count of the
+ * number of nodes (or the size) of the list and either:
+ * The array backend - A buffer of capacity data pointers of which
+ * 	the count pointers starting at items[start] are in use. Keeping
+ * 	a start offset lets the head be removed without shifting the rest.
+ * The linked backend - A pointer to the head of the list (NULL if the
+ * 	list is empty) and the pool its nodes are allocated from. Nodes are
+ * 	recycled through the pool and all freed together with the list.
+ * Either way dataArena is where listAlloc allocates the data, or NULL
+ * 	until it is first called.*/
 typedef struct
 {
+#ifdef LLIST_ARRAY
+	void **items;
+	size_t start;
+	size_t capacity;
+#else
 	LLNode *head;
+	Pool nodePool;
+#endif
+	Arena dataArena;
 	size_t count;
 } *LList;
 
@@ -53,7 +73,8 @@ LList listCreate( void );
  *  Description: Creates a shallow copy of a list. Simply copies the data
  *  	inside the nodes. Does not copy what the data may point towards.
  *  	The caller should be careful about whether a list created with listCopy
- *  	should be freed with listDestroy or listDestroyFree.
+ *  	should be freed with listDestroy or listDestroyFree. Data allocated
+ *  	with listAlloc still belongs to inList, and goes when it is destroyed.
  *
  *  LList inList - The list to be copied. Must be non-null.
  *
@@ -67,7 +88,8 @@ LList listCopy( LList inList );
  * listDestroy
  * Description: Destroys a linked list. Does not free the data INSIDE the
  * nodes, just the nodes themselves. Any allocated data inside the nodes would
- * need to be free by the caller or by calling listDestroyFree.
+ * need to be free by the caller or by calling listDestroyFree. Data allocated
+ * with listAlloc is the exception, and is freed along with the list.
  *
  *  LList list - The list to be destroy
  *
@@ -82,7 +104,9 @@ void listDestroy( LList list );
  * Description: Destroys a linked list. Attempts to free the data inside the 
  * nodes. This should NOT be used when the data inside the nodes has not been
  * dynamically allocated. Do not mix dynamic and static memory in your list and
- * then use this function.
+ * then use this function. If the data was allocated with listAlloc it is all
+ * freed at once without visiting the nodes, so it must not be mixed with data
+ * allocated with malloc either.
  *
  *  LList list - The list to destroy
  *  
@@ -91,6 +115,21 @@ void listDestroy( LList list );
 void listDestroyFree( LList list );
 
 
+/****
+ *  listAlloc
+ *  Description: Allocates memory for data that is to be added to a list.
+ *  	It comes from an arena owned by the list, so it can not be freed on
+ *  	its own, and all of it is freed in a handful of calls to free when
+ *  	the list is destroyed.
+ *
+ *  LList list - The list the data is for. Must be non-null.
+ *  size_t size - The number of bytes wanted.
+ *
+ *  Returns a pointer to size bytes, valid until the list is destroyed.
+ */
+void *listAlloc( LList list, size_t size );
+
+
 /* LIST ACCESS */
 
 /* Position is between 1 and count */
@@ -154,7 +193,9 @@ size_t listSize( LList list );
  *  listSort
  *  Description: Sorts the list by comparing the elements using the caller-supplied
  *  	callback 'cmp'. cmp should return -1 when arg1 < arg2, 0 when arg1 = arg2,
- * 	and 1 when arg1 > arg2 
+ * 	and 1 when arg1 > arg2. The sort is a stable O(n log n) merge sort, so
+ * 	elements that compare equal keep their relative order. The linked backend
+ * 	relinks the existing nodes and allocates nothing.
  *
  *  LList list - The list to sort. Must be non-null.
  *  int (*cmp)( const void *, const void* ) - The comparison function supplied by
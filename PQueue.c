@@ -0,0 +1,127 @@
+#include "PQueue.h"
+
+
+/* The smallest buffer a queue will be created with */
+#define PQUEUE_MIN_CAPACITY 16
+
+/* TRUE if entry a should leave the queue before entry b */
+#define PQUEUE_LESS( a, b ) ( (a)->key < (b)->key || ( (a)->key == (b)->key && (a)->tie < (b)->tie ) )
+
+
+PQueue pQueueCreate( size_t capacity )
+{
+	PQueue newQueue;
+
+	if( capacity < PQUEUE_MIN_CAPACITY )
+	{
+		capacity = PQUEUE_MIN_CAPACITY;
+	}
+
+	newQueue = malloc( sizeof *newQueue );
+	newQueue->items = malloc( capacity * sizeof *newQueue->items );
+	SIM_STAT( simAllocs += 2; )
+	newQueue->count = 0;
+	newQueue->capacity = capacity;
+
+	return newQueue;
+}
+
+
+void pQueueDestroy( PQueue queue )
+{
+	assert( queue != NULL );
+
+	/* Records are stored by value so there is nothing else to free */
+	free( queue->items );
+	free( queue );
+}
+
+
+void pQueueInsert( PQueue queue, simTime key, int64_t tie, const struct simJob *data )
+{
+	struct pqEntry newEntry;
+	size_t pos;
+
+	assert( queue != NULL );
+	assert( data != NULL );
+
+	if( queue->count == queue->capacity )
+	{
+		queue->capacity *= 2;
+		queue->items = realloc( queue->items, queue->capacity * sizeof *queue->items );
+		SIM_STAT( simAllocs++; )
+	}
+
+	newEntry.key = key;
+	newEntry.tie = tie;
+	newEntry.data = *data;
+
+	/* Sift up. Start at the new last position and move parents down
+	 * until the new entry's place is found */
+	pos = queue->count;
+	while( pos > 0 )
+	{
+		size_t parent = ( pos - 1 ) / PQUEUE_ARITY;
+
+		if( !PQUEUE_LESS( &newEntry, &queue->items[parent] ) )
+		{
+			break;
+		}
+		queue->items[pos] = queue->items[parent];
+		pos = parent;
+	}
+	queue->items[pos] = newEntry;
+	queue->count++;
+}
+
+
+void pQueueExtractMin( PQueue queue, struct simJob *outData )
+{
+	struct pqEntry *last;
+	size_t pos;
+
+	assert( queue != NULL && queue->count > 0 );
+	assert( outData != NULL );
+
+	*outData = queue->items[0].data;
+	queue->count--;
+
+	/* Sift down. The last entry is moved in to the hole at the root and
+	 * the smallest child is moved up until the last entry's place is found */
+	last = &queue->items[queue->count];
+	pos = 0;
+	while( PQUEUE_ARITY * pos + 1 < queue->count )
+	{
+		size_t child, minChild, end;
+
+		minChild = PQUEUE_ARITY * pos + 1;
+		end = minChild + PQUEUE_ARITY;
+		if( end > queue->count )
+		{
+			end = queue->count;
+		}
+		for( child = minChild + 1; child < end; child++ )
+		{
+			if( PQUEUE_LESS( &queue->items[child], &queue->items[minChild] ) )
+			{
+				minChild = child;
+			}
+		}
+
+		if( !PQUEUE_LESS( &queue->items[minChild], last ) )
+		{
+			break;
+		}
+		queue->items[pos] = queue->items[minChild];
+		pos = minChild;
+	}
+	queue->items[pos] = *last;
+}
+
+
+size_t pQueueSize( PQueue queue )
+{
+	assert( queue != NULL );
+
+	return queue->count;
+}
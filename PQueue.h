@@ -0,0 +1,116 @@
+/* PQueue.h
+ * A priority queue of shortest job first
+ * housekeeping records. The queue is a d-ary
+ * min-heap stored in a single array. Each record is
+ * kept by value next to its key so that comparisons
+ * never have to follow a pointer. Inserting and
+ * removing the minimum are both O(log n).
+ */
+
+#ifndef PQUEUE_H
+#define PQUEUE_H
+
+#include <stdlib.h>
+#include "common.h"
+#include "simengine.h"
+
+
+/* The number of children of each node in the heap. A wider heap is
+ * shallower, so an insert does fewer comparisons and an extract touches
+ * fewer cache lines, at the cost of comparing more children per level. */
+#define PQUEUE_ARITY 4
+
+
+/* A single entry in the heap. Entries are ordered by key and then by tie,
+ * so two entries only compare equal when both are the same.
+ * simTime key - The priority of the entry. Smaller keys come out first.
+ * int64_t tie - Decides the order of entries with equal keys. Smaller first.
+ * struct simJob data - The record itself. */
+struct pqEntry
+{
+	simTime key;
+	int64_t tie;
+	struct simJob data;
+};
+
+
+/* A structure to represent the priority queue. items is an array of
+ * capacity entries of which the first count make up the heap. The
+ * children of items[i] are items[PQUEUE_ARITY * i + 1] onwards. */
+typedef struct PQueue
+{
+	struct pqEntry *items;
+	size_t count;
+	size_t capacity;
+} *PQueue;
+
+
+/* CREATION/DESTRUCTION */
+
+/****
+ *  pQueueCreate
+ *  Description: Creates an empty priority queue.
+ *
+ *  size_t capacity - The number of entries the queue should be able to
+ *  	hold before it needs to grow.
+ *
+ *  Returns a new empty queue. This should be freed with pQueueDestroy.
+ */
+PQueue pQueueCreate( size_t capacity );
+
+
+/****
+ *  pQueueDestroy
+ *  Description: Destroys a queue along with any entries still inside it.
+ *
+ *  PQueue queue - The queue to destroy. Must be non-null.
+ *
+ *  Returns nothing.
+ */
+void pQueueDestroy( PQueue queue );
+
+
+/* QUEUE ACCESS */
+
+/****
+ *  pQueueInsert
+ *  Description: Copies a record in to the queue. The queue doubles in size
+ *  	if it is full.
+ *
+ *  PQueue queue - The queue to insert in to. Must be non-null.
+ *  simTime key - The priority of the record. Smaller keys are removed first.
+ *  int64_t tie - Breaks ties between equal keys. Smaller values are removed
+ *  	first.
+ *  const struct simJob *data - The record to copy in. Must be non-null.
+ *
+ *  Returns nothing.
+ */
+void pQueueInsert( PQueue queue, simTime key, int64_t tie, const struct simJob *data );
+
+
+/****
+ *  pQueueExtractMin
+ *  Description: Removes the record with the smallest key (and then the
+ *  	smallest tie) from the queue.
+ *
+ *  PQueue queue - The queue to remove from. Must be non-null and non-empty.
+ *  struct simJob *outData - Where to copy the removed record. Must be
+ *  	non-null.
+ *
+ *  Returns nothing.
+ */
+void pQueueExtractMin( PQueue queue, struct simJob *outData );
+
+
+/****
+ *  pQueueSize
+ *  Description: The number of records in the queue.
+ *
+ *  PQueue queue - The queue whose size is desired. Must be non-null.
+ *
+ *  Returns the number of records in the queue.
+ */
+size_t pQueueSize( PQueue queue );
+
+
+#endif
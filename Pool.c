@@ -0,0 +1,64 @@
+#include "Pool.h"
+
+
+Pool poolCreate( size_t itemSize, size_t itemsPerChunk )
+{
+	Pool newPool;
+
+	assert( itemSize > 0 );
+
+	/* A free object has to be able to hold the free list link */
+	if( itemSize < sizeof( void * ) )
+	{
+		itemSize = sizeof( void * );
+	}
+	itemSize = ( itemSize + ARENA_ALIGN - 1 ) / ARENA_ALIGN * ARENA_ALIGN;
+
+	newPool = malloc( sizeof *newPool );
+	SIM_STAT( simAllocs++; )
+	newPool->arena = arenaCreate( itemSize * ( itemsPerChunk > 0 ? itemsPerChunk : 1 ) );
+	newPool->itemSize = itemSize;
+	newPool->freeList = NULL;
+
+	return newPool;
+}
+
+
+void poolDestroy( Pool pool )
+{
+	assert( pool != NULL );
+
+	arenaDestroy( pool->arena );
+	free( pool );
+}
+
+
+void *poolAlloc( Pool pool )
+{
+	void *item;
+
+	assert( pool != NULL );
+
+	/* Reuse the most recently freed object if there is one */
+	if( pool->freeList != NULL )
+	{
+		item = pool->freeList;
+		pool->freeList = *(void **)item;
+	}
+	else
+	{
+		item = arenaAlloc( pool->arena, pool->itemSize );
+	}
+
+	return item;
+}
+
+
+void poolFree( Pool pool, void *item )
+{
+	assert( pool != NULL );
+	assert( item != NULL );
+
+	*(void **)item = pool->freeList;
+	pool->freeList = item;
+}
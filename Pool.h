@@ -0,0 +1,82 @@
+/* Pool.h
+ * A pool of fixed size objects. Objects are carved
+ * from an arena and freed objects are kept on a free
+ * list to be handed out again, so allocating and
+ * freeing are both O(1) and never touch the heap
+ * once the pool is warm. Destroying the pool frees
+ * every object in it at once.
+ */
+
+#ifndef POOL_H
+#define POOL_H
+
+#include <stdlib.h>
+#include "common.h"
+#include "Arena.h"
+
+
+/* A structure to represent a pool.
+ * arena - Where new objects are carved from.
+ * itemSize - The size of each object. At least the size of a pointer, as a
+ * 	free object holds the link to the next free object.
+ * freeList - The most recently freed object, or NULL if there are none. */
+typedef struct Pool
+{
+	Arena arena;
+	size_t itemSize;
+	void *freeList;
+} *Pool;
+
+
+/* CREATION/DESTRUCTION */
+
+/****
+ *  poolCreate
+ *  Description: Creates an empty pool.
+ *
+ *  size_t itemSize - The size of the objects in the pool. Must be positive.
+ *  size_t itemsPerChunk - The number of objects to make room for at a time.
+ *
+ *  Returns a new pool. This should be freed with poolDestroy.
+ */
+Pool poolCreate( size_t itemSize, size_t itemsPerChunk );
+
+
+/****
+ *  poolDestroy
+ *  Description: Destroys a pool and every object allocated from it, whether
+ *  	or not it was freed.
+ *
+ *  Pool pool - The pool to destroy. Must be non-null.
+ *
+ *  Returns nothing.
+ */
+void poolDestroy( Pool pool );
+
+
+/* ALLOCATION */
+
+/****
+ *  poolAlloc
+ *  Description: Allocates an object from a pool.
+ *
+ *  Pool pool - The pool to allocate from. Must be non-null.
+ *
+ *  Returns a pointer to an uninitialised object.
+ */
+void *poolAlloc( Pool pool );
+
+
+/****
+ *  poolFree
+ *  Description: Gives an object back to its pool to be reused.
+ *
+ *  Pool pool - The pool the object came from. Must be non-null.
+ *  void *item - The object. Must be non-null.
+ *
+ *  Returns nothing.
+ */
+void poolFree( Pool pool, void *item );
+
+
+#endif
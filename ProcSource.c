@@ -0,0 +1,269 @@
+#include "ProcSource.h"
+
+
+/****
+ *  psCreate
+ *  Description: Allocates a source with everything cleared, ready for one of
+ *  	the psFrom functions to fill in.
+ *
+ *  Returns the new source.
+ */
+static ProcSource psCreate( void )
+{
+	ProcSource newSrc;
+
+	newSrc = malloc( sizeof *newSrc );
+	newSrc->fill = NULL;
+	newSrc->release = NULL;
+	newSrc->haveNext = FALSE;
+	newSrc->count = 0;
+	newSrc->pos = 0;
+	newSrc->list = NULL;
+	newSrc->table = NULL;
+	newSrc->order = NULL;
+	newSrc->stream = NULL;
+
+	return newSrc;
+}
+
+
+/* Fetches the next process from a sorted list */
+static int psFillList( ProcSource src )
+{
+	int found = FALSE;
+
+	if( src->pos < listSize( src->list ) )
+	{
+		src->pos++;
+		src->next = *(struct proc *)listGet( src->list, src->pos );
+		found = TRUE;
+	}
+
+	return found;
+}
+
+
+/* Frees the sorted copy of the list */
+static void psReleaseList( ProcSource src )
+{
+	listDestroy( src->list );
+}
+
+
+ProcSource psFromList( LList inProcList, int (*cmp)( const void *arg1, const void *arg2 ) )
+{
+	ProcSource newSrc;
+
+	assert( inProcList != NULL );
+	assert( cmp != NULL );
+
+	/* Create a copy of inProcList so that we can sort it */
+	newSrc = psCreate();
+	newSrc->list = listCopy( inProcList );
+	listSort( newSrc->list, cmp );
+	newSrc->count = listSize( inProcList );
+	newSrc->fill = psFillList;
+	newSrc->release = psReleaseList;
+	newSrc->haveNext = newSrc->fill( newSrc );
+
+	return newSrc;
+}
+
+
+/* Fetches the next process from a table that is in order of arrival */
+static int psFillTable( ProcSource src )
+{
+	int found = FALSE;
+
+	if( src->pos < ptSize( src->table ) )
+	{
+		src->pos++;
+		src->next.pNo = src->pos;
+		src->next.arrivalTime = ptArrival( src->table, src->pos );
+		src->next.burstTime = ptBurst( src->table, src->pos );
+		found = TRUE;
+	}
+
+	return found;
+}
+
+
+/* Fetches the next process from an array in order of arrival */
+static int psFillOrder( ProcSource src )
+{
+	int found = FALSE;
+
+	if( src->pos < src->count )
+	{
+		src->next = src->order[src->pos];
+		src->pos++;
+		found = TRUE;
+	}
+
+	return found;
+}
+
+
+/* Frees the sorted copy of a table */
+static void psReleaseOrder( ProcSource src )
+{
+	free( (struct proc *)src->order );
+}
+
+
+/* Orders processes by arrival time and then by process number. qsort is not
+ * stable but no two processes share a number, so the order is fixed. */
+static int psOrderCmp( const void *arg1, const void *arg2 )
+{
+	const struct proc *p1, *p2;
+	int result;
+
+	p1 = arg1;
+	p2 = arg2;
+
+	if( p1->arrivalTime != p2->arrivalTime )
+	{
+		result = p1->arrivalTime < p2->arrivalTime ? -1 : 1;
+	}
+	else
+	{
+		result = p1->pNo < p2->pNo ? -1 : ( p1->pNo > p2->pNo );
+	}
+
+	return result;
+}
+
+
+ProcSource psFromTable( ProcTable table )
+{
+	ProcSource newSrc;
+
+	assert( table != NULL );
+
+	newSrc = psCreate();
+	newSrc->table = table;
+	newSrc->count = ptSize( table );
+
+	if( ptSorted( table ) )
+	{
+		/* Already in order. Hand the processes out straight from the
+		 * table's columns */
+		newSrc->fill = psFillTable;
+	}
+	else
+	{
+		/* Gather the processes together and sort them by arrival */
+		newSrc->order = psOrderTable( table );
+		newSrc->fill = psFillOrder;
+		newSrc->release = psReleaseOrder;
+	}
+	newSrc->haveNext = newSrc->fill( newSrc );
+
+	return newSrc;
+}
+
+
+struct proc *psOrderTable( ProcTable table )
+{
+	struct proc *order;
+	size_t count, i;
+
+	assert( table != NULL );
+
+	count = ptSize( table );
+	order = malloc( ( count > 0 ? count : 1 ) * sizeof *order );
+	for( i = 0; i < count; i++ )
+	{
+		order[i].pNo = i + 1;
+		order[i].arrivalTime = ptArrival( table, i + 1 );
+		order[i].burstTime = ptBurst( table, i + 1 );
+	}
+	qsort( order, count, sizeof *order, psOrderCmp );
+
+	return order;
+}
+
+
+ProcSource psFromOrder( const struct proc *order, size_t count )
+{
+	ProcSource newSrc;
+
+	assert( order != NULL );
+
+	/* The array belongs to the caller, so nothing is released */
+	newSrc = psCreate();
+	newSrc->order = order;
+	newSrc->count = count;
+	newSrc->fill = psFillOrder;
+	newSrc->haveNext = newSrc->fill( newSrc );
+
+	return newSrc;
+}
+
+
+/* Reads the next process from a stream, counting it as it goes */
+static int psFillStream( ProcSource src )
+{
+	int found;
+
+	found = procStreamNext( src->stream, &src->next );
+	if( found )
+	{
+		src->count++;
+	}
+
+	return found;
+}
+
+
+ProcSource psFromStream( ProcStream stream )
+{
+	ProcSource newSrc;
+
+	assert( stream != NULL );
+
+	newSrc = psCreate();
+	newSrc->stream = stream;
+	newSrc->fill = psFillStream;
+	newSrc->haveNext = newSrc->fill( newSrc );
+
+	return newSrc;
+}
+
+
+void psDestroy( ProcSource src )
+{
+	assert( src != NULL );
+
+	if( src->release != NULL )
+	{
+		src->release( src );
+	}
+	free( src );
+}
+
+
+const struct proc *psPeek( ProcSource src )
+{
+	assert( src != NULL );
+
+	return src->haveNext ? &src->next : NULL;
+}
+
+
+void psPop( ProcSource src, struct proc *outProc )
+{
+	assert( src != NULL && src->haveNext );
+	assert( outProc != NULL );
+
+	*outProc = src->next;
+	src->haveNext = src->fill( src );
+}
+
+
+size_t psSize( ProcSource src )
+{
+	assert( src != NULL );
+
+	return src->count;
+}
@@ -0,0 +1,182 @@
+/* ProcSource.h
+ * A source of processes for the simulations.
+ * A source hands out processes one at a time in
+ * order of arrival, so a simulation only has to
+ * look at the next one to know whether it has
+ * arrived yet. Sources can be made from a list of
+ * processes, from a process table or from a stream,
+ * and the simulations do not need to know which.
+ */
+
+#ifndef PROCSOURCE_H
+#define PROCSOURCE_H
+
+#include <stdlib.h>
+#include "common.h"
+#include "LList.h"
+#include "ProcTable.h"
+#include "ProcStream.h"
+#include "proc.h"
+
+
+/* A structure to represent a process source.
+ * fill - Fetches the process after the current one in to next. Returns
+ * 	FALSE when there are no more.
+ * release - Frees whatever the kind of source holds on to.
+ * next - The next process to be handed out, valid while haveNext is TRUE.
+ * count - The total number of processes the source will hand out. For a
+ * 	stream this is the number read so far.
+ * pos - How many processes the backing list or table has handed out.
+ * list - The sorted list for a source made from a list.
+ * table - The table for a source made from a table.
+ * order - The processes in order of arrival, for a source made from a
+ * 	table that was not already in order or from an array. NULL otherwise.
+ * stream - The stream for a source made from a stream. */
+typedef struct ProcSource
+{
+	int (*fill)( struct ProcSource *src );
+	void (*release)( struct ProcSource *src );
+	struct proc next;
+	int haveNext;
+	size_t count;
+	size_t pos;
+	LList list;
+	ProcTable table;
+	const struct proc *order;
+	ProcStream stream;
+} *ProcSource;
+
+
+/* CREATION/DESTRUCTION */
+
+/****
+ *  psFromList
+ *  Description: Creates a source that hands out the processes in a list.
+ *  	The source sorts its own copy of the list, leaving the original as it
+ *  	is.
+ *
+ *  LList inProcList - The list of struct proc * to hand out. Must be
+ *  	non-null and must outlive the source.
+ *  int (*cmp)( const void *, const void * ) - The comparison to sort by, as
+ *  	for listSort. It must put earlier arrivals first.
+ *
+ *  Returns a new source. This should be freed with psDestroy.
+ */
+ProcSource psFromList( LList inProcList, int (*cmp)( const void *arg1, const void *arg2 ) );
+
+
+/****
+ *  psFromTable
+ *  Description: Creates a source that hands out the processes in a table.
+ *  	A table that is already in order of arrival is read in place.
+ *  	Otherwise the processes are sorted by arrival time and then by
+ *  	process number.
+ *
+ *  ProcTable table - The table to hand out. Must be non-null and must
+ *  	outlive the source. The source never modifies it.
+ *
+ *  Returns a new source. This should be freed with psDestroy.
+ */
+ProcSource psFromTable( ProcTable table );
+
+
+/****
+ *  psOrderTable
+ *  Description: Gathers the processes in a table in to an array in the
+ *  	order psFromTable hands them out, by arrival time and then by process
+ *  	number. A table that is not in order can then be sorted once and
+ *  	shared by any number of sources made with psFromOrder.
+ *
+ *  ProcTable table - The table. Must be non-null.
+ *
+ *  Returns a new array of ptSize( table ) processes. It should be freed
+ *  	with free.
+ */
+struct proc *psOrderTable( ProcTable table );
+
+
+/****
+ *  psFromOrder
+ *  Description: Creates a source that hands out the processes in an array
+ *  	that is already in order of arrival, such as one from psOrderTable.
+ *  	The array is read in place.
+ *
+ *  const struct proc *order - The processes. Must be non-null and must
+ *  	outlive the source. The source never modifies it, so any number of
+ *  	sources may share it at once.
+ *  size_t count - The number of processes in order.
+ *
+ *  Returns a new source. This should be freed with psDestroy.
+ */
+ProcSource psFromOrder( const struct proc *order, size_t count );
+
+
+/****
+ *  psFromStream
+ *  Description: Creates a source that hands out the processes in a stream,
+ *  	reading each one only when it is asked for. Nothing is sorted, so the
+ *  	stream must already be in order of arrival. If it is not, or if the
+ *  	file turns out to be badly formatted, the source simply ends early and
+ *  	procStreamError reports why.
+ *
+ *  ProcStream stream - The stream to hand out. Must be non-null and must
+ *  	outlive the source.
+ *
+ *  Returns a new source. This should be freed with psDestroy.
+ */
+ProcSource psFromStream( ProcStream stream );
+
+
+/****
+ *  psDestroy
+ *  Description: Destroys a source. The list or table it was made from is
+ *  	left alone.
+ *
+ *  ProcSource src - The source to destroy. Must be non-null.
+ *
+ *  Returns nothing.
+ */
+void psDestroy( ProcSource src );
+
+
+/* SOURCE ACCESS */
+
+/****
+ *  psPeek
+ *  Description: Looks at the next process without taking it.
+ *
+ *  ProcSource src - The source. Must be non-null.
+ *
+ *  Returns a pointer to the next process, or NULL if there are none left.
+ *  	The pointer is only valid until the next call to psPop.
+ */
+const struct proc *psPeek( ProcSource src );
+
+
+/****
+ *  psPop
+ *  Description: Takes the next process from the source.
+ *
+ *  ProcSource src - The source. Must be non-null and must have a process
+ *  	left (psPeek is non-null).
+ *  struct proc *outProc - Where to copy the process. Must be non-null.
+ *
+ *  Returns nothing.
+ */
+void psPop( ProcSource src, struct proc *outProc );
+
+
+/****
+ *  psSize
+ *  Description: The total number of processes the source hands out. For a
+ *  	source made from a stream this is only known once the source is
+ *  	empty. Until then it is the number read so far.
+ *
+ *  ProcSource src - The source. Must be non-null.
+ *
+ *  Returns the number of processes.
+ */
+size_t psSize( ProcSource src );
+
+
+#endif
@@ -0,0 +1,385 @@
+#include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "ProcStream.h"
+
+
+/****
+ *  procStreamRead
+ *  Description: Reads more of a text file in to the buffer. The part of a
+ *  	line that is left is first moved to the front of the buffer, or the
+ *  	buffer is made bigger if that line already fills it.
+ *
+ *  ProcStream stream - The stream.
+ *
+ *  Returns nothing. atEof is set once there is nothing left to read.
+ */
+static void procStreamRead( ProcStream stream )
+{
+	ssize_t numRead;
+
+	if( stream->start > 0 )
+	{
+		memmove( stream->buf, stream->buf + stream->start, stream->end - stream->start );
+		stream->end -= stream->start;
+		stream->start = 0;
+	}
+	else if( stream->end == stream->bufSize )
+	{
+		stream->bufSize *= 2;
+		stream->buf = realloc( stream->buf, stream->bufSize );
+	}
+
+	numRead = read( stream->fd, stream->buf + stream->end, stream->bufSize - stream->end );
+	if( numRead > 0 )
+	{
+		stream->end += numRead;
+	}
+	else
+	{
+		stream->atEof = TRUE;
+		if( numRead < 0 )
+		{
+			stream->error = PROC_NO_OPEN;
+		}
+	}
+}
+
+
+/****
+ *  procStreamLine
+ *  Description: Reads the integers on the next line of a text file.
+ *
+ *  ProcStream stream - The stream.
+ *  simTime *values - Where to place the integers, as for procScanLine.
+ *  int *outNumValues - Where to place the result of procScanLine.
+ *
+ *  Returns TRUE if there was a line to read, FALSE at the end of the file.
+ */
+static int procStreamLine( ProcStream stream, simTime *values, int *outNumValues )
+{
+	const char *pos, *nl;
+	int found;
+
+	/* Make sure the whole line is in the buffer */
+	nl = memchr( stream->buf + stream->start, '\n', stream->end - stream->start );
+	while( nl == NULL && !stream->atEof )
+	{
+		procStreamRead( stream );
+		nl = memchr( stream->buf + stream->start, '\n', stream->end - stream->start );
+	}
+
+	found = ( stream->start < stream->end );
+	if( found )
+	{
+		pos = stream->buf + stream->start;
+		stream->line++;
+		*outNumValues = procScanLine( &pos, nl != NULL ? nl + 1 : stream->buf + stream->end, values );
+		stream->start = pos - stream->buf;
+	}
+
+	return found;
+}
+
+
+/****
+ *  procStreamBinary
+ *  Description: Checks the header of a binary file at the front of the
+ *  	buffer and sets the stream up to read the columns that follow it. The
+ *  	buffer is made big enough for a piece of each column.
+ *
+ *  ProcStream stream - The stream.
+ *
+ *  Returns PROC_NO_ERROR, or PROC_BAD_FORMAT if the header is not valid or
+ *  	the file is too short for its columns.
+ */
+static int procStreamBinary( ProcStream stream )
+{
+	struct procBinHeader header;
+	struct stat info;
+	int error = PROC_BAD_FORMAT;
+
+	size_t width;
+
+	memcpy( &header, stream->buf, sizeof header );
+	width = ( header.version == PROC_BIN_VERSION_INT32 ) ? sizeof( int32_t ) : sizeof( simTime );
+	if( ( header.version == PROC_BIN_VERSION || header.version == PROC_BIN_VERSION_INT32 ) &&
+		fstat( stream->fd, &info ) == 0 && header.count <= ( info.st_size - sizeof header ) / ( 2 * width ) )
+	{
+		stream->binary = TRUE;
+		stream->narrow = ( width == sizeof( int32_t ) );
+		stream->quantum = header.quantum;
+		stream->remaining = header.count;
+		stream->arrivalOff = sizeof header;
+		stream->burstOff = sizeof header + header.count * width;
+		if( stream->bufSize < 2 * PROCSTREAM_COLUMN_LEN * sizeof( simTime ) )
+		{
+			stream->bufSize = 2 * PROCSTREAM_COLUMN_LEN * sizeof( simTime );
+			stream->buf = realloc( stream->buf, stream->bufSize );
+		}
+		error = PROC_NO_ERROR;
+	}
+
+	return error;
+}
+
+
+/****
+ *  procStreamWiden
+ *  Description: Widens a piece of an int32_t column, read in to the front
+ *  	of where it belongs, to simTime where it lies. It is done from the
+ *  	back so that no value is overwritten before it has been widened.
+ *
+ *  simTime *column - The piece of the column.
+ *  size_t len - The number of values in it.
+ *
+ *  Returns nothing.
+ */
+static void procStreamWiden( simTime *column, size_t len )
+{
+	const int32_t *narrow = (const int32_t *)column;
+
+	while( len > 0 )
+	{
+		len--;
+		column[len] = narrow[len];
+	}
+}
+
+
+/****
+ *  procStreamColumns
+ *  Description: Reads the next arrival and burst time from a binary file.
+ *  	The two columns are read a piece at a time in to the two halves of
+ *  	the buffer.
+ *
+ *  ProcStream stream - The stream.
+ *  simTime *values - Where to place the arrival time and the burst time.
+ *
+ *  Returns TRUE if a process was read, FALSE at the end of the file or if
+ *  	the file could not be read.
+ */
+static int procStreamColumns( ProcStream stream, simTime *values )
+{
+	simTime *arrival = (simTime *)stream->buf;
+	simTime *burst = arrival + PROCSTREAM_COLUMN_LEN;
+	int found;
+
+	if( stream->colPos == stream->colLen && stream->remaining > 0 )
+	{
+		size_t len, numBytes;
+
+		len = stream->remaining < PROCSTREAM_COLUMN_LEN ? stream->remaining : PROCSTREAM_COLUMN_LEN;
+		numBytes = len * ( stream->narrow ? sizeof( int32_t ) : sizeof *arrival );
+		if( pread( stream->fd, arrival, numBytes, stream->arrivalOff ) != (ssize_t)numBytes ||
+			pread( stream->fd, burst, numBytes, stream->burstOff ) != (ssize_t)numBytes )
+		{
+			stream->error = PROC_NO_OPEN;
+		}
+		else
+		{
+			if( stream->narrow )
+			{
+				procStreamWiden( arrival, len );
+				procStreamWiden( burst, len );
+			}
+			stream->arrivalOff += numBytes;
+			stream->burstOff += numBytes;
+			stream->remaining -= len;
+			stream->colPos = 0;
+			stream->colLen = len;
+		}
+	}
+
+	found = ( stream->error == PROC_NO_ERROR && stream->colPos < stream->colLen );
+	if( found )
+	{
+		values[0] = arrival[stream->colPos];
+		values[1] = burst[stream->colPos];
+		stream->colPos++;
+	}
+
+	return found;
+}
+
+
+int procStreamOpen( const char *inFileName, ProcStream *outStream, size_t *outLine )
+{
+	ProcStream stream;
+	simTime values[PROC_MAX_FIELDS];
+	int numValues = 0;
+	int more = TRUE;
+	int error = PROC_NO_ERROR;
+
+	assert( outStream != NULL );
+
+	stream = malloc( sizeof *stream );
+	stream->binary = FALSE;
+	stream->narrow = FALSE;
+	stream->bufSize = PROCSTREAM_BUF_SIZE;
+	stream->buf = malloc( stream->bufSize );
+	stream->start = stream->end = 0;
+	stream->atEof = FALSE;
+	stream->remaining = 0;
+	stream->arrivalOff = stream->burstOff = 0;
+	stream->colPos = stream->colLen = 0;
+	stream->quantum = 0;
+	stream->pNo = 0;
+	stream->lastArrival = 0;
+	stream->line = 0;
+	stream->error = PROC_NO_ERROR;
+
+	/* Attempt to open the given file */
+	stream->fd = open( inFileName, O_RDONLY );
+	if( stream->fd < 0 )
+	{
+		error = PROC_NO_OPEN;
+	}
+	else
+	{
+		/* Read enough of the file to tell which format it is in */
+		while( !stream->atEof && stream->end < sizeof( struct procBinHeader ) )
+		{
+			procStreamRead( stream );
+		}
+
+		if( stream->end >= sizeof( struct procBinHeader ) &&
+			memcmp( stream->buf, PROC_BIN_MAGIC, sizeof( ((struct procBinHeader *)0)->magic ) ) == 0 )
+		{
+			error = procStreamBinary( stream );
+		}
+		else
+		{
+			/* Skip any blank lines and read the quantum */
+			while( more && numValues == 0 )
+			{
+				more = procStreamLine( stream, values, &numValues );
+			}
+
+			if( numValues == 1 && PROC_VALID_QUANTUM( values[0] ) )
+			{
+				stream->quantum = values[0];
+			}
+			else /* Could not read quantum */
+			{
+				error = PROC_BAD_FORMAT;
+			}
+		}
+
+		if( stream->error != PROC_NO_ERROR )
+		{
+			error = stream->error;
+		}
+	}
+
+	if( outLine != NULL )
+	{
+		*outLine = ( error == PROC_BAD_FORMAT ) ? ( stream->line > 0 ? stream->line : 1 ) : 0;
+	}
+	if( error == PROC_NO_ERROR )
+	{
+		*outStream = stream;
+	}
+	else
+	{
+		procStreamClose( stream );
+	}
+
+	return error;
+}
+
+
+void procStreamClose( ProcStream stream )
+{
+	assert( stream != NULL );
+
+	if( stream->fd >= 0 )
+	{
+		close( stream->fd );
+	}
+	free( stream->buf );
+	free( stream );
+}
+
+
+int procStreamNext( ProcStream stream, struct proc *outProc )
+{
+	simTime values[PROC_MAX_FIELDS];
+	int numValues = 0;
+	int more = TRUE;
+	int found = FALSE;
+
+	assert( stream != NULL );
+	assert( outProc != NULL );
+
+	if( stream->error == PROC_NO_ERROR )
+	{
+		if( stream->binary )
+		{
+			if( procStreamColumns( stream, values ) )
+			{
+				numValues = PROC_MAX_FIELDS;
+				stream->line++;
+			}
+		}
+		else
+		{
+			/* Skip any blank lines */
+			while( more && numValues == 0 )
+			{
+				more = procStreamLine( stream, values, &numValues );
+			}
+		}
+
+		if( stream->error != PROC_NO_ERROR ) /* The file could not be read */
+		{
+			found = FALSE;
+		}
+		else if( numValues == PROC_MAX_FIELDS )
+		{
+			/* There is no way to sort a stream so the processes have to
+			 * come in order */
+			if( stream->pNo > 0 && values[0] < stream->lastArrival )
+			{
+				stream->error = PROC_NOT_SORTED;
+			}
+			else
+			{
+				stream->pNo++;
+				stream->lastArrival = values[0];
+				outProc->pNo = stream->pNo;
+				outProc->arrivalTime = values[0];
+				outProc->burstTime = values[1];
+				found = TRUE;
+			}
+		}
+		else if( numValues != 0 ) /* Fields not formatted properly */
+		{
+			stream->error = PROC_BAD_FORMAT;
+		}
+	}
+
+	return found;
+}
+
+
+int procStreamQuantum( ProcStream stream )
+{
+	assert( stream != NULL );
+
+	return stream->quantum;
+}
+
+
+int procStreamError( ProcStream stream, size_t *outLine )
+{
+	assert( stream != NULL );
+
+	if( outLine != NULL )
+	{
+		*outLine = ( stream->error != PROC_NO_ERROR ) ? stream->line : 0;
+	}
+
+	return stream->error;
+}
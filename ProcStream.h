@@ -0,0 +1,143 @@
+/* ProcStream.h
+ * A workload file read a little at a time. Only a
+ * small buffer of the file is ever held in memory,
+ * so a stream can hand out any number of processes
+ * in constant space. Both the text and the binary
+ * workload formats can be streamed. The processes
+ * must already be in order of arrival as there is
+ * no way to sort them without holding them all.
+ */
+
+#ifndef PROCSTREAM_H
+#define PROCSTREAM_H
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <sys/types.h>
+#include "common.h"
+#include "proc.h"
+
+/* The size of the text buffer to start with. It only grows if a single
+ * line will not fit */
+#define PROCSTREAM_BUF_SIZE 65536
+/* The number of entries of each column read at once from a binary file */
+#define PROCSTREAM_COLUMN_LEN 8192
+
+
+/* A structure to represent a stream of processes.
+ * fd - The open workload file.
+ * binary - TRUE if the file is in the binary workload format.
+ * narrow - TRUE if the columns of a binary file are int32_t, as in
+ * 	PROC_BIN_VERSION_INT32. They are widened as they are read.
+ * buf, bufSize - The read buffer. For a binary file it holds
+ * 	PROCSTREAM_COLUMN_LEN arrival times and then as many burst times.
+ * start, end - The unread part of the text buffer.
+ * atEof - TRUE once the whole text file has been read in to the buffer.
+ * remaining - The number of processes in a binary file not yet read in to
+ * 	the buffer.
+ * arrivalOff, burstOff - Where the next unread arrival and burst times are
+ * 	in a binary file.
+ * colPos, colLen - The next entry of the buffered columns and the number
+ * 	buffered.
+ * quantum - The quantum read from the file.
+ * pNo - The number of processes handed out so far.
+ * lastArrival - The arrival time of the last process handed out.
+ * line - The current line of a text file, or the current process of a binary
+ * 	file.
+ * error - PROC_NO_ERROR, or the error that ended the stream. */
+typedef struct ProcStream
+{
+	int fd;
+	int binary;
+	int narrow;
+	char *buf;
+	size_t bufSize;
+	size_t start;
+	size_t end;
+	int atEof;
+	uint64_t remaining;
+	off_t arrivalOff;
+	off_t burstOff;
+	size_t colPos;
+	size_t colLen;
+	int quantum;
+	int64_t pNo;
+	simTime lastArrival;
+	size_t line;
+	int error;
+} *ProcStream;
+
+
+/* CREATION/DESTRUCTION */
+
+/****
+ *  procStreamOpen
+ *  Description: Opens a workload file for streaming and reads its quantum.
+ *  	No processes are read until they are asked for.
+ *
+ *  const char *inFileName - The name of the file to stream.
+ *  ProcStream *outStream - Where to place the new stream if no error occurs.
+ *  size_t *outLine - Where to place the number of the offending line if the
+ *  	file is badly formatted. May be NULL.
+ *
+ *  Returns PROC_NO_ERROR, PROC_NO_OPEN or PROC_BAD_FORMAT. On success the
+ *  	stream should be freed with procStreamClose.
+ */
+int procStreamOpen( const char *inFileName, ProcStream *outStream, size_t *outLine );
+
+
+/****
+ *  procStreamClose
+ *  Description: Closes a stream and frees everything it holds.
+ *
+ *  ProcStream stream - The stream to close. Must be non-null.
+ *
+ *  Returns nothing.
+ */
+void procStreamClose( ProcStream stream );
+
+
+/* STREAM ACCESS */
+
+/****
+ *  procStreamNext
+ *  Description: Reads the next process from the stream. Process numbers
+ *  	count up from 1 in the order the processes appear in the file.
+ *
+ *  ProcStream stream - The stream. Must be non-null.
+ *  struct proc *outProc - Where to place the process. Must be non-null.
+ *
+ *  Returns TRUE if a process was read. FALSE at the end of the file or if an
+ *  	error has occurred, which procStreamError tells apart.
+ */
+int procStreamNext( ProcStream stream, struct proc *outProc );
+
+
+/****
+ *  procStreamQuantum
+ *  Description: The quantum read from the top of the file.
+ *
+ *  ProcStream stream - The stream. Must be non-null.
+ *
+ *  Returns the quantum.
+ */
+int procStreamQuantum( ProcStream stream );
+
+
+/****
+ *  procStreamError
+ *  Description: Finds out whether the stream ended early.
+ *
+ *  ProcStream stream - The stream. Must be non-null.
+ *  size_t *outLine - Where to place the line of a text file, or the process of
+ *  	a binary file, that caused the error. Zero if there is no error. May
+ *  	be NULL.
+ *
+ *  Returns PROC_NO_ERROR, PROC_NO_OPEN if the file could not be read,
+ *  	PROC_BAD_FORMAT if a line is badly formatted or PROC_NOT_SORTED if a
+ *  	process arrives before the one above it.
+ */
+int procStreamError( ProcStream stream, size_t *outLine );
+
+
+#endif
@@ -0,0 +1,177 @@
+#include <string.h>
+#include <sys/mman.h>
+#include "ProcTable.h"
+
+
+/* The smallest number of processes a table will be created with room for */
+#define PROCTABLE_MIN_CAPACITY 16
+
+
+ProcTable ptCreate( size_t capacity, int quantum )
+{
+	ProcTable newTable;
+
+	if( capacity < PROCTABLE_MIN_CAPACITY )
+	{
+		capacity = PROCTABLE_MIN_CAPACITY;
+	}
+
+	newTable = malloc( sizeof *newTable );
+	newTable->arrival = malloc( capacity * sizeof *newTable->arrival );
+	newTable->burst = malloc( capacity * sizeof *newTable->burst );
+	newTable->count = 0;
+	newTable->capacity = capacity;
+	newTable->quantum = quantum;
+	/* An empty table is trivially in order */
+	newTable->sorted = TRUE;
+	newTable->map = NULL;
+	newTable->mapLen = 0;
+
+	return newTable;
+}
+
+
+ProcTable ptCreateMapped( const simTime *arrival, const simTime *burst, size_t count, int quantum, int sorted, void *map, size_t mapLen )
+{
+	ProcTable newTable;
+
+	assert( arrival != NULL && burst != NULL );
+	assert( map != NULL );
+
+	/* The columns are only ever read through the table so it is safe to
+	 * cast away const here */
+	newTable = malloc( sizeof *newTable );
+	newTable->arrival = (simTime *)arrival;
+	newTable->burst = (simTime *)burst;
+	newTable->count = count;
+	newTable->capacity = count;
+	newTable->quantum = quantum;
+	newTable->sorted = sorted;
+	newTable->map = map;
+	newTable->mapLen = mapLen;
+
+	return newTable;
+}
+
+
+void ptDestroy( ProcTable table )
+{
+	assert( table != NULL );
+
+	if( table->map != NULL )
+	{
+		munmap( table->map, table->mapLen );
+	}
+	else
+	{
+		free( table->arrival );
+		free( table->burst );
+	}
+	free( table );
+}
+
+
+void ptAdd( ProcTable table, simTime arrivalTime, simTime burstTime )
+{
+	assert( table != NULL );
+	assert( table->map == NULL );
+
+	if( table->count == table->capacity )
+	{
+		table->capacity *= 2;
+		table->arrival = realloc( table->arrival, table->capacity * sizeof *table->arrival );
+		table->burst = realloc( table->burst, table->capacity * sizeof *table->burst );
+	}
+
+	/* The table stays sorted only while arrivals never go backwards */
+	if( table->count > 0 && arrivalTime < table->arrival[table->count - 1] )
+	{
+		table->sorted = FALSE;
+	}
+
+	table->arrival[table->count] = arrivalTime;
+	table->burst[table->count] = burstTime;
+	table->count++;
+}
+
+
+void ptAppend( ProcTable table, const simTime *arrival, const simTime *burst, size_t count )
+{
+	size_t i;
+	simTime prevArrival;
+
+	assert( table != NULL );
+	assert( table->map == NULL );
+	assert( count == 0 || ( arrival != NULL && burst != NULL ) );
+
+	if( table->count + count > table->capacity )
+	{
+		while( table->count + count > table->capacity )
+		{
+			table->capacity *= 2;
+		}
+		table->arrival = realloc( table->arrival, table->capacity * sizeof *table->arrival );
+		table->burst = realloc( table->burst, table->capacity * sizeof *table->burst );
+	}
+
+	/* The table stays sorted only while arrivals never go backwards, both
+	 * where the new processes join on and among the new processes */
+	prevArrival = ( table->count > 0 ) ? table->arrival[table->count - 1] : ( count > 0 ? arrival[0] : 0 );
+	for( i = 0; table->sorted && i < count; i++ )
+	{
+		if( arrival[i] < prevArrival )
+		{
+			table->sorted = FALSE;
+		}
+		prevArrival = arrival[i];
+	}
+
+	if( count > 0 )
+	{
+		memcpy( table->arrival + table->count, arrival, count * sizeof *arrival );
+		memcpy( table->burst + table->count, burst, count * sizeof *burst );
+		table->count += count;
+	}
+}
+
+
+size_t ptSize( ProcTable table )
+{
+	assert( table != NULL );
+
+	return table->count;
+}
+
+
+int ptQuantum( ProcTable table )
+{
+	assert( table != NULL );
+
+	return table->quantum;
+}
+
+
+int ptSorted( ProcTable table )
+{
+	assert( table != NULL );
+
+	return table->sorted;
+}
+
+
+simTime ptArrival( ProcTable table, size_t pNo )
+{
+	assert( table != NULL );
+	assert( 1 <= pNo && pNo <= table->count );
+
+	return table->arrival[pNo - 1];
+}
+
+
+simTime ptBurst( ProcTable table, size_t pNo )
+{
+	assert( table != NULL );
+	assert( 1 <= pNo && pNo <= table->count );
+
+	return table->burst[pNo - 1];
+}
@@ -0,0 +1,176 @@
+/* ProcTable.h
+ * A flat table of processes. Rather than one
+ * record per process the table keeps one array
+ * (column) of arrival times and one of burst
+ * times, each allocated once. The process number
+ * of a process is simply its index in the table,
+ * which like the LList module is 1-based.
+ */
+
+#ifndef PROCTABLE_H
+#define PROCTABLE_H
+
+#include <stdlib.h>
+#include "common.h"
+
+
+/* A structure to represent a process table.
+ * arrival, burst - The columns. Each has room for capacity entries of
+ * 	which the first count are in use. Process n is at index n - 1.
+ * quantum - The round robin quantum that goes with the processes.
+ * sorted - TRUE while every process arrives no earlier than the one before
+ * 	it, which lets a simulation use the table in order without sorting.
+ * map, mapLen - The mapped file that the columns point in to, for a table
+ * 	created with ptCreateMapped. NULL and 0 otherwise. */
+typedef struct ProcTable
+{
+	simTime *arrival;
+	simTime *burst;
+	size_t count;
+	size_t capacity;
+	int quantum;
+	int sorted;
+	void *map;
+	size_t mapLen;
+} *ProcTable;
+
+
+/* CREATION/DESTRUCTION */
+
+/****
+ *  ptCreate
+ *  Description: Creates an empty process table.
+ *
+ *  size_t capacity - The number of processes to allocate room for. A table
+ *  	created with enough room for all of its processes never reallocates.
+ *  int quantum - The round robin quantum to store with the table.
+ *
+ *  Returns a new empty table. This should be freed with ptDestroy.
+ */
+ProcTable ptCreate( size_t capacity, int quantum );
+
+
+/****
+ *  ptCreateMapped
+ *  Description: Creates a read-only process table whose columns are part
+ *  	of a memory mapped file. Nothing is copied. The table takes over the
+ *  	mapping and unmaps it when it is destroyed.
+ *
+ *  const simTime *arrival - The column of count arrival times. Must be
+ *  	non-null.
+ *  const simTime *burst - The column of count burst times. Must be non-null.
+ *  size_t count - The number of processes.
+ *  int quantum - The round robin quantum to store with the table.
+ *  int sorted - TRUE if the processes are known to be in order of arrival.
+ *  void *map - The start of the mapping that holds the columns.
+ *  size_t mapLen - The length of the mapping.
+ *
+ *  Returns a new table. No processes can be added to it with ptAdd. It
+ *  should be freed with ptDestroy.
+ */
+ProcTable ptCreateMapped( const simTime *arrival, const simTime *burst, size_t count, int quantum, int sorted, void *map, size_t mapLen );
+
+
+/****
+ *  ptDestroy
+ *  Description: Destroys a process table and its columns, unmapping them if
+ *  	they were part of a mapped file.
+ *
+ *  ProcTable table - The table to destroy. Must be non-null.
+ *
+ *  Returns nothing.
+ */
+void ptDestroy( ProcTable table );
+
+
+/* TABLE ACCESS */
+
+/****
+ *  ptAdd
+ *  Description: Adds a process to the end of the table. Its process number
+ *  	is the new size of the table. The columns double in size if full.
+ *
+ *  ProcTable table - The table to add to. Must be non-null and must not have
+ *  	been created with ptCreateMapped.
+ *  simTime arrivalTime - The arrival time of the new process.
+ *  simTime burstTime - The burst time of the new process.
+ *
+ *  Returns nothing.
+ */
+void ptAdd( ProcTable table, simTime arrivalTime, simTime burstTime );
+
+
+/****
+ *  ptAppend
+ *  Description: Adds a run of processes to the end of the table in one go.
+ *  	The columns are copied across whole rather than a process at a time.
+ *
+ *  ProcTable table - The table to add to. Must be non-null and must not have
+ *  	been created with ptCreateMapped.
+ *  const simTime *arrival - The arrival times of the new processes.
+ *  const simTime *burst - The burst times of the new processes.
+ *  size_t count - The number of processes to add.
+ *
+ *  Returns nothing.
+ */
+void ptAppend( ProcTable table, const simTime *arrival, const simTime *burst, size_t count );
+
+
+/****
+ *  ptSize
+ *  Description: The number of processes in the table.
+ *
+ *  ProcTable table - The table whose size is desired. Must be non-null.
+ *
+ *  Returns the number of processes in the table.
+ */
+size_t ptSize( ProcTable table );
+
+
+/****
+ *  ptQuantum
+ *  Description: The round robin quantum stored with the table.
+ *
+ *  ProcTable table - The table. Must be non-null.
+ *
+ *  Returns the quantum.
+ */
+int ptQuantum( ProcTable table );
+
+
+/****
+ *  ptSorted
+ *  Description: Whether the processes are in order of arrival time.
+ *
+ *  ProcTable table - The table. Must be non-null.
+ *
+ *  Returns TRUE if no process arrives before the one preceding it.
+ */
+int ptSorted( ProcTable table );
+
+
+/****
+ *  ptArrival
+ *  Description: The arrival time of a process in the table.
+ *
+ *  ProcTable table - The table. Must be non-null.
+ *  size_t pNo - The process number. Must be between 1 and ptSize( table ).
+ *
+ *  Returns the arrival time of process pNo.
+ */
+simTime ptArrival( ProcTable table, size_t pNo );
+
+
+/****
+ *  ptBurst
+ *  Description: The burst time of a process in the table.
+ *
+ *  ProcTable table - The table. Must be non-null.
+ *  size_t pNo - The process number. Must be between 1 and ptSize( table ).
+ *
+ *  Returns the burst time of process pNo.
+ */
+simTime ptBurst( ProcTable table, size_t pNo );
+
+
+#endif
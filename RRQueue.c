@@ -0,0 +1,82 @@
+#include <string.h>
+#include "RRQueue.h"
+
+
+/* The smallest buffer a queue will be created with */
+#define RRQUEUE_MIN_CAPACITY 16
+
+
+RRQueue rrQueueCreate( size_t capacity )
+{
+	RRQueue newQueue;
+	size_t size;
+
+	/* Round the capacity up to a power of two so that positions in the
+	 * ring can be wrapped with a mask instead of a division */
+	size = RRQUEUE_MIN_CAPACITY;
+	while( size < capacity )
+	{
+		size *= 2;
+	}
+
+	newQueue = malloc( sizeof *newQueue );
+	newQueue->items = malloc( size * sizeof *newQueue->items );
+	SIM_STAT( simAllocs += 2; )
+	newQueue->head = 0;
+	newQueue->count = 0;
+	newQueue->mask = size - 1;
+
+	return newQueue;
+}
+
+
+void rrQueueDestroy( RRQueue queue )
+{
+	assert( queue != NULL );
+
+	/* Records are stored by value so there is nothing else to free */
+	free( queue->items );
+	free( queue );
+}
+
+
+void rrQueuePush( RRQueue queue, const struct simJob *data )
+{
+	assert( queue != NULL );
+	assert( data != NULL );
+
+	/* Queue is full. Double the buffer and move the records that had
+	 * wrapped around to the start into the new upper half so the ring is
+	 * contiguous again */
+	if( queue->count == queue->mask + 1 )
+	{
+		size_t oldSize = queue->mask + 1;
+
+		queue->items = realloc( queue->items, 2 * oldSize * sizeof *queue->items );
+		SIM_STAT( simAllocs++; )
+		memcpy( queue->items + oldSize, queue->items, queue->head * sizeof *queue->items );
+		queue->mask = 2 * oldSize - 1;
+	}
+
+	queue->items[( queue->head + queue->count ) & queue->mask] = *data;
+	queue->count++;
+}
+
+
+void rrQueuePop( RRQueue queue, struct simJob *outData )
+{
+	assert( queue != NULL && queue->count > 0 );
+	assert( outData != NULL );
+
+	*outData = queue->items[queue->head];
+	queue->head = ( queue->head + 1 ) & queue->mask;
+	queue->count--;
+}
+
+
+size_t rrQueueSize( RRQueue queue )
+{
+	assert( queue != NULL );
+
+	return queue->count;
+}
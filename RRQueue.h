@@ -0,0 +1,97 @@
+/* RRQueue.h
+ * A first-in first-out queue of round robin
+ * housekeeping records. The records are stored
+ * by value in a ring buffer whose capacity is
+ * always a power of two, so adding to the back and
+ * removing from the front are both O(1) and never
+ * allocate unless the queue has to grow.
+ */
+
+#ifndef RRQUEUE_H
+#define RRQUEUE_H
+
+#include <stdlib.h>
+#include "common.h"
+#include "simengine.h"
+
+
+/* A structure to represent the queue. items is a ring buffer of
+ * (mask + 1) records. The count records starting at items[head] (wrapping
+ * around the end of the buffer) are in the queue, oldest first. */
+typedef struct RRQueue
+{
+	struct simJob *items;
+	size_t head;
+	size_t count;
+	size_t mask;
+} *RRQueue;
+
+
+/* CREATION/DESTRUCTION */
+
+/****
+ *  rrQueueCreate
+ *  Description: Creates an empty queue.
+ *
+ *  size_t capacity - The number of records the queue should be able to hold
+ *  	before it needs to grow. This is rounded up to a power of two. A
+ *  	queue that is sized for the largest number of records it will ever
+ *  	hold never allocates again.
+ *
+ *  Returns a new empty queue. This should be freed with rrQueueDestroy.
+ */
+RRQueue rrQueueCreate( size_t capacity );
+
+
+/****
+ *  rrQueueDestroy
+ *  Description: Destroys a queue along with any records still inside it.
+ *
+ *  RRQueue queue - The queue to destroy. Must be non-null.
+ *
+ *  Returns nothing.
+ */
+void rrQueueDestroy( RRQueue queue );
+
+
+/* QUEUE ACCESS */
+
+/****
+ *  rrQueuePush
+ *  Description: Copies a record on to the back of the queue. The queue
+ *  	doubles in size if it is full.
+ *
+ *  RRQueue queue - The queue to add to. Must be non-null.
+ *  const struct simJob *data - The record to copy in. Must be non-null.
+ *
+ *  Returns nothing.
+ */
+void rrQueuePush( RRQueue queue, const struct simJob *data );
+
+
+/****
+ *  rrQueuePop
+ *  Description: Removes the record at the front of the queue.
+ *
+ *  RRQueue queue - The queue to remove from. Must be non-null and
+ *  	non-empty.
+ *  struct simJob *outData - Where to copy the removed record. Must be
+ *  	non-null.
+ *
+ *  Returns nothing.
+ */
+void rrQueuePop( RRQueue queue, struct simJob *outData );
+
+
+/****
+ *  rrQueueSize
+ *  Description: The number of records in the queue.
+ *
+ *  RRQueue queue - The queue whose size is desired. Must be non-null.
+ *
+ *  Returns the number of records in the queue.
+ */
+size_t rrQueueSize( RRQueue queue );
+
+
+#endif
@@ -0,0 +1,75 @@
+#include "ResultRing.h"
+
+
+ResultRing resultRingCreate( size_t capacity )
+{
+	ResultRing newRing;
+	size_t size = 1;
+
+	while( size < capacity )
+	{
+		size *= 2;
+	}
+
+	newRing = malloc( sizeof *newRing );
+	newRing->items = malloc( size * sizeof *newRing->items );
+	newRing->mask = size - 1;
+	atomic_init( &newRing->head, 0 );
+	atomic_init( &newRing->tail, 0 );
+
+	return newRing;
+}
+
+
+void resultRingDestroy( ResultRing ring )
+{
+	assert( ring != NULL );
+
+	free( ring->items );
+	free( ring );
+}
+
+
+int resultRingPush( ResultRing ring, const struct workerResult *result )
+{
+	size_t head, tail;
+	int added;
+
+	assert( ring != NULL );
+	assert( result != NULL );
+
+	/* Only this thread writes tail. Acquiring head makes sure the consumer
+	 * has finished copying out of a slot before it is reused */
+	tail = atomic_load_explicit( &ring->tail, memory_order_relaxed );
+	head = atomic_load_explicit( &ring->head, memory_order_acquire );
+	added = ( tail - head <= ring->mask );
+	if( added )
+	{
+		ring->items[tail & ring->mask] = *result;
+		/* Release so the result is visible before the new tail is */
+		atomic_store_explicit( &ring->tail, tail + 1, memory_order_release );
+	}
+
+	return added;
+}
+
+
+int resultRingPop( ResultRing ring, struct workerResult *outResult )
+{
+	size_t head, tail;
+	int found;
+
+	assert( ring != NULL );
+	assert( outResult != NULL );
+
+	head = atomic_load_explicit( &ring->head, memory_order_relaxed );
+	tail = atomic_load_explicit( &ring->tail, memory_order_acquire );
+	found = ( head != tail );
+	if( found )
+	{
+		*outResult = ring->items[head & ring->mask];
+		atomic_store_explicit( &ring->head, head + 1, memory_order_release );
+	}
+
+	return found;
+}
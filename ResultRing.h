@@ -0,0 +1,104 @@
+/* ResultRing.h
+ * A lock-free ring buffer of simulation results for
+ * exactly one producer thread and one consumer
+ * thread. Each side only ever writes its own index,
+ * so neither side ever blocks or takes a lock, and
+ * the producer never waits on the consumer unless
+ * the ring is full.
+ */
+
+#ifndef RESULTRING_H
+#define RESULTRING_H
+
+#include <stdlib.h>
+#include <stdatomic.h>
+#include "common.h"
+#include "simengine.h"
+
+/* The size of a cache line. The two indexes are kept this far apart so
+ * that the producer and consumer do not fight over one line */
+#define RESULTRING_CACHE_LINE 64
+
+
+/* A result from a worker thread.
+ * error - PROC_NO_ERROR, or the error that stopped the workload loading.
+ * aveTurn, aveWait - The averages, if there was no error.
+ * stats - What the simulation did, if there was no error. */
+struct workerResult
+{
+	int error;
+	double aveTurn;
+	double aveWait;
+	struct simStats stats;
+};
+
+
+/* A structure to represent a ring. items is a buffer of (mask + 1)
+ * results. head is the number of results ever taken, written only by the
+ * consumer, and tail the number ever added, written only by the producer.
+ * The results from items[head & mask] up to items[tail & mask] are in the
+ * ring. */
+typedef struct ResultRing
+{
+	struct workerResult *items;
+	size_t mask;
+	atomic_size_t head;
+	char pad[RESULTRING_CACHE_LINE];
+	atomic_size_t tail;
+} *ResultRing;
+
+
+/* CREATION/DESTRUCTION */
+
+/****
+ *  resultRingCreate
+ *  Description: Creates an empty ring.
+ *
+ *  size_t capacity - The most results the ring can hold. Rounded up to a
+ *  	power of two.
+ *
+ *  Returns a new ring. This should be freed with resultRingDestroy.
+ */
+ResultRing resultRingCreate( size_t capacity );
+
+
+/****
+ *  resultRingDestroy
+ *  Description: Destroys a ring. Neither thread may be using it.
+ *
+ *  ResultRing ring - The ring to destroy. Must be non-null.
+ *
+ *  Returns nothing.
+ */
+void resultRingDestroy( ResultRing ring );
+
+
+/* RING ACCESS */
+
+/****
+ *  resultRingPush
+ *  Description: Adds a result to the ring. Must only be called by the
+ *  	producer thread.
+ *
+ *  ResultRing ring - The ring. Must be non-null.
+ *  const struct workerResult *result - The result to copy in.
+ *
+ *  Returns TRUE if the result was added, FALSE if the ring was full.
+ */
+int resultRingPush( ResultRing ring, const struct workerResult *result );
+
+
+/****
+ *  resultRingPop
+ *  Description: Takes the oldest result from the ring. Must only be called
+ *  	by the consumer thread.
+ *
+ *  ResultRing ring - The ring. Must be non-null.
+ *  struct workerResult *outResult - Where to copy the result.
+ *
+ *  Returns TRUE if a result was taken, FALSE if the ring was empty.
+ */
+int resultRingPop( ResultRing ring, struct workerResult *outResult );
+
+
+#endif
@@ -0,0 +1,294 @@
+#include <unistd.h>
+#include "WorkPool.h"
+
+
+/****
+ *  workDequePush
+ *  Description: Adds a task to the back of a deque, doubling it if full.
+ *
+ *  struct workDeque *deque - The deque.
+ *  const struct workTask *task - The task to copy in.
+ *
+ *  Returns nothing.
+ */
+static void workDequePush( struct workDeque *deque, const struct workTask *task )
+{
+	pthread_mutex_lock( &deque->lock );
+	if( deque->count == deque->capacity )
+	{
+		size_t i;
+		struct workTask *items;
+
+		/* Copy across oldest first so the ring starts at 0 again */
+		items = malloc( 2 * deque->capacity * sizeof *items );
+		for( i = 0; i < deque->count; i++ )
+		{
+			items[i] = deque->items[( deque->head + i ) % deque->capacity];
+		}
+		free( deque->items );
+		deque->items = items;
+		deque->head = 0;
+		deque->capacity *= 2;
+	}
+	deque->items[( deque->head + deque->count ) % deque->capacity] = *task;
+	deque->count++;
+	pthread_mutex_unlock( &deque->lock );
+}
+
+
+/****
+ *  workDequeTake
+ *  Description: Takes a task from a deque.
+ *
+ *  struct workDeque *deque - The deque.
+ *  int steal - FALSE to take the newest task, as the owner does, or TRUE to
+ *  	take the oldest, as a thief does.
+ *  struct workTask *outTask - Where to copy the task.
+ *
+ *  Returns TRUE if a task was taken, FALSE if the deque was empty.
+ */
+static int workDequeTake( struct workDeque *deque, int steal, struct workTask *outTask )
+{
+	int found;
+
+	pthread_mutex_lock( &deque->lock );
+	found = ( deque->count > 0 );
+	if( found && steal )
+	{
+		*outTask = deque->items[deque->head];
+		deque->head = ( deque->head + 1 ) % deque->capacity;
+		deque->count--;
+	}
+	else if( found )
+	{
+		deque->count--;
+		*outTask = deque->items[( deque->head + deque->count ) % deque->capacity];
+	}
+	pthread_mutex_unlock( &deque->lock );
+
+	return found;
+}
+
+
+/****
+ *  workFind
+ *  Description: Finds a task for a worker, from its own deque if possible
+ *  	and otherwise by stealing from each of the others in turn.
+ *
+ *  WorkPool pool - The pool.
+ *  int id - The worker's index.
+ *  struct workTask *outTask - Where to copy the task.
+ *
+ *  Returns TRUE if a task was found.
+ */
+static int workFind( WorkPool pool, int id, struct workTask *outTask )
+{
+	int found;
+	int i;
+
+	found = workDequeTake( &pool->deques[id], FALSE, outTask );
+	for( i = 1; !found && i < pool->numWorkers; i++ )
+	{
+		found = workDequeTake( &pool->deques[( id + i ) % pool->numWorkers], TRUE, outTask );
+	}
+
+	return found;
+}
+
+
+/****
+ *  workThread
+ *  Description: The worker thread. Runs tasks until the pool shuts down,
+ *  	sleeping whenever there are none queued anywhere.
+ *
+ *  void *attr - The worker's struct workDeque.
+ *
+ *  Returns NULL.
+ */
+static void *workThread( void *attr )
+{
+	struct workDeque *deque = attr;
+	WorkPool pool = deque->pool;
+	int id = deque - pool->deques;
+	int running = TRUE;
+
+	while( running )
+	{
+		struct workTask task;
+
+		if( workFind( pool, id, &task ) )
+		{
+			pthread_mutex_lock( &pool->lock );
+			pool->queued--;
+			pthread_mutex_unlock( &pool->lock );
+
+			task.run( task.arg );
+
+			pthread_mutex_lock( &pool->lock );
+			pool->pending--;
+			if( pool->pending == 0 )
+			{
+				pthread_cond_broadcast( &pool->doneCond );
+			}
+			pthread_mutex_unlock( &pool->lock );
+		}
+		else
+		{
+			/* Nothing to run. Sleep until something is queued. queued
+			 * is counted under the pool's lock, so a task that arrived
+			 * after the deques were searched is not missed */
+			pthread_mutex_lock( &pool->lock );
+			while( pool->queued == 0 && !pool->shutdown )
+			{
+				pthread_cond_wait( &pool->workCond, &pool->lock );
+			}
+			running = ( pool->queued > 0 || !pool->shutdown );
+			pthread_mutex_unlock( &pool->lock );
+		}
+	}
+
+	return NULL;
+}
+
+
+/****
+ *  workPoolStop
+ *  Description: Tells the workers to exit once the deques are empty, waits
+ *  	for them and frees the pool.
+ *
+ *  WorkPool pool - The pool.
+ *  int numThreads - The number of worker threads that were started.
+ *
+ *  Returns nothing.
+ */
+static void workPoolStop( WorkPool pool, int numThreads )
+{
+	int i;
+
+	pthread_mutex_lock( &pool->lock );
+	pool->shutdown = TRUE;
+	pthread_mutex_unlock( &pool->lock );
+	pthread_cond_broadcast( &pool->workCond );
+
+	for( i = 0; i < numThreads; i++ )
+	{
+		pthread_join( pool->threads[i], NULL );
+	}
+
+	for( i = 0; i < pool->numWorkers; i++ )
+	{
+		pthread_mutex_destroy( &pool->deques[i].lock );
+		free( pool->deques[i].items );
+	}
+	pthread_cond_destroy( &pool->doneCond );
+	pthread_cond_destroy( &pool->workCond );
+	pthread_mutex_destroy( &pool->lock );
+	free( pool->threads );
+	free( pool->deques );
+	free( pool );
+}
+
+
+WorkPool workPoolCreate( int numWorkers )
+{
+	WorkPool newPool;
+	int numStarted = 0;
+	int i;
+
+	if( numWorkers <= 0 )
+	{
+		numWorkers = sysconf( _SC_NPROCESSORS_ONLN );
+	}
+
+	newPool = malloc( sizeof *newPool );
+	newPool->deques = malloc( numWorkers * sizeof *newPool->deques );
+	newPool->threads = malloc( numWorkers * sizeof *newPool->threads );
+	newPool->numWorkers = numWorkers;
+	newPool->nextDeque = 0;
+	newPool->queued = 0;
+	newPool->pending = 0;
+	newPool->shutdown = FALSE;
+	pthread_mutex_init( &newPool->lock, NULL );
+	pthread_cond_init( &newPool->workCond, NULL );
+	pthread_cond_init( &newPool->doneCond, NULL );
+
+	for( i = 0; i < numWorkers; i++ )
+	{
+		newPool->deques[i].items = malloc( WORKPOOL_DEQUE_CAPACITY * sizeof *newPool->deques[i].items );
+		newPool->deques[i].head = 0;
+		newPool->deques[i].count = 0;
+		newPool->deques[i].capacity = WORKPOOL_DEQUE_CAPACITY;
+		newPool->deques[i].pool = newPool;
+		pthread_mutex_init( &newPool->deques[i].lock, NULL );
+	}
+
+	while( numStarted < numWorkers &&
+		pthread_create( &newPool->threads[numStarted], NULL, workThread, &newPool->deques[numStarted] ) == 0 )
+	{
+		numStarted++;
+	}
+
+	/* Could not start every worker. Stop the ones that did start */
+	if( numStarted < numWorkers )
+	{
+		workPoolStop( newPool, numStarted );
+		newPool = NULL;
+	}
+
+	return newPool;
+}
+
+
+void workPoolDestroy( WorkPool pool )
+{
+	assert( pool != NULL );
+
+	workPoolWait( pool );
+	workPoolStop( pool, pool->numWorkers );
+}
+
+
+void workPoolSubmit( WorkPool pool, void (*run)( void *arg ), void *arg )
+{
+	struct workTask task;
+	int id;
+
+	assert( pool != NULL );
+	assert( run != NULL );
+
+	task.run = run;
+	task.arg = arg;
+
+	/* Deal the task to the next worker in turn */
+	pthread_mutex_lock( &pool->lock );
+	id = pool->nextDeque;
+	pool->nextDeque = ( pool->nextDeque + 1 ) % pool->numWorkers;
+	pool->pending++;
+	pool->queued++;
+	pthread_mutex_unlock( &pool->lock );
+
+	/* A worker woken before the push lands just looks again */
+	workDequePush( &pool->deques[id], &task );
+	pthread_cond_signal( &pool->workCond );
+}
+
+
+void workPoolWait( WorkPool pool )
+{
+	assert( pool != NULL );
+
+	pthread_mutex_lock( &pool->lock );
+	while( pool->pending > 0 )
+	{
+		pthread_cond_wait( &pool->doneCond, &pool->lock );
+	}
+	pthread_mutex_unlock( &pool->lock );
+}
+
+
+int workPoolSize( WorkPool pool )
+{
+	assert( pool != NULL );
+
+	return pool->numWorkers;
+}
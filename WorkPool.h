@@ -0,0 +1,137 @@
+/* WorkPool.h
+ * A pool of worker threads that run tasks, with
+ * work stealing. Each worker has its own deque of
+ * tasks. A worker runs the newest task from its own
+ * deque, and when that is empty it steals the
+ * oldest task from another worker's deque, so one
+ * long task never leaves the tasks queued behind it
+ * waiting while other workers sit idle.
+ */
+
+#ifndef WORKPOOL_H
+#define WORKPOOL_H
+
+#include <stdlib.h>
+#include <pthread.h>
+#include "common.h"
+
+/* The number of tasks a worker's deque has room for before it grows */
+#define WORKPOOL_DEQUE_CAPACITY 64
+
+
+/* A task for the pool to run. run is called with arg by one of the
+ * workers. */
+struct workTask
+{
+	void (*run)( void *arg );
+	void *arg;
+};
+
+
+/* A worker's deque of tasks. items is a ring buffer of capacity tasks. The
+ * count tasks starting at items[head] are queued, oldest first. The owner
+ * takes from the back and thieves take from the front. lock must be held to
+ * use those fields. pool is the pool the deque's worker belongs to. */
+struct workDeque
+{
+	struct workTask *items;
+	size_t head;
+	size_t count;
+	size_t capacity;
+	pthread_mutex_t lock;
+	struct WorkPool *pool;
+};
+
+
+/* A structure to represent a pool.
+ * deques - One deque per worker.
+ * threads - The worker threads.
+ * numWorkers - The number of workers.
+ * nextDeque - The deque the next task submitted will go to.
+ * queued - The number of tasks in all of the deques.
+ * pending - The number of tasks submitted that have not yet finished.
+ * shutdown - Set when the workers should exit.
+ * lock - Guards nextDeque, queued, pending and shutdown.
+ * workCond - Signalled when a task is queued or the pool shuts down.
+ * doneCond - Signalled when pending drops to zero. */
+typedef struct WorkPool
+{
+	struct workDeque *deques;
+	pthread_t *threads;
+	int numWorkers;
+	int nextDeque;
+	size_t queued;
+	size_t pending;
+	int shutdown;
+	pthread_mutex_t lock;
+	pthread_cond_t workCond;
+	pthread_cond_t doneCond;
+} *WorkPool;
+
+
+/* CREATION/DESTRUCTION */
+
+/****
+ *  workPoolCreate
+ *  Description: Creates a pool and starts its workers.
+ *
+ *  int numWorkers - The number of worker threads. Zero or less means one for
+ *  	every online processor.
+ *
+ *  Returns a new pool, or NULL if the threads could not be started. This
+ *  	should be freed with workPoolDestroy.
+ */
+WorkPool workPoolCreate( int numWorkers );
+
+
+/****
+ *  workPoolDestroy
+ *  Description: Waits for every submitted task to finish, stops the workers
+ *  	and destroys the pool.
+ *
+ *  WorkPool pool - The pool to destroy. Must be non-null.
+ *
+ *  Returns nothing.
+ */
+void workPoolDestroy( WorkPool pool );
+
+
+/* POOL ACCESS */
+
+/****
+ *  workPoolSubmit
+ *  Description: Queues a task. Tasks are dealt out to the workers' deques
+ *  	in turn.
+ *
+ *  WorkPool pool - The pool. Must be non-null.
+ *  void (*run)( void *arg ) - The function to run. Must be non-null.
+ *  void *arg - The argument to pass it.
+ *
+ *  Returns nothing.
+ */
+void workPoolSubmit( WorkPool pool, void (*run)( void *arg ), void *arg );
+
+
+/****
+ *  workPoolWait
+ *  Description: Waits until every task submitted so far has finished.
+ *
+ *  WorkPool pool - The pool. Must be non-null.
+ *
+ *  Returns nothing.
+ */
+void workPoolWait( WorkPool pool );
+
+
+/****
+ *  workPoolSize
+ *  Description: The number of workers in the pool.
+ *
+ *  WorkPool pool - The pool. Must be non-null.
+ *
+ *  Returns the number of workers.
+ */
+int workPoolSize( WorkPool pool );
+
+
+#endif
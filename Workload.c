@@ -0,0 +1,46 @@
+#include <string.h>
+#include "Workload.h"
+
+
+Workload workloadLoad( const char *inFileName, int numThreads, int numRefs )
+{
+	Workload newWorkload;
+
+	assert( inFileName != NULL );
+	assert( numRefs > 0 );
+
+	newWorkload = malloc( sizeof *newWorkload );
+	newWorkload->fileName = malloc( strlen( inFileName ) + 1 );
+	strcpy( newWorkload->fileName, inFileName );
+	newWorkload->table = NULL;
+	atomic_init( &newWorkload->refs, numRefs );
+
+	/* Parse the file on as many threads as it is worth, up to the
+	 * caller's limit */
+	newWorkload->error = procReadTableParallel( inFileName, numThreads, &newWorkload->table, NULL );
+	if( newWorkload->error != PROC_NO_ERROR )
+	{
+		newWorkload->table = NULL;
+	}
+
+	return newWorkload;
+}
+
+
+void workloadRelease( Workload workload )
+{
+	assert( workload != NULL );
+
+	/* The holder that takes the count to zero is the only one left, so it
+	 * can free the workload without a lock. Every other holder's reads of
+	 * the table happen before its own decrement */
+	if( atomic_fetch_sub_explicit( &workload->refs, 1, memory_order_acq_rel ) == 1 )
+	{
+		if( workload->table != NULL )
+		{
+			ptDestroy( workload->table );
+		}
+		free( workload->fileName );
+		free( workload );
+	}
+}
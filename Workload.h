@@ -0,0 +1,68 @@
+/* Workload.h
+ * A workload file loaded once and shared, read
+ * only, between any number of threads. Each
+ * thread that is handed the workload holds one
+ * reference to it, and the last one to let go
+ * frees it, so a file is only ever read and
+ * parsed once however many algorithms run on it.
+ */
+
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include <stdlib.h>
+#include <stdatomic.h>
+#include "common.h"
+#include "proc.h"
+#include "ProcTable.h"
+
+
+/* A structure to represent a shared workload.
+ * fileName - A copy of the name of the file it was loaded from.
+ * table - The processes. NULL if the file could not be loaded. It must not
+ * 	be changed once the workload is shared.
+ * error - PROC_NO_ERROR, or the error from loading the file.
+ * refs - The number of holders that have not yet released it. */
+typedef struct Workload
+{
+	char *fileName;
+	ProcTable table;
+	int error;
+	atomic_int refs;
+} *Workload;
+
+
+/* CREATION/DESTRUCTION */
+
+/****
+ *  workloadLoad
+ *  Description: Loads a workload file in to a new shared workload. A file
+ *  	that can not be loaded still gives a workload, holding the error, so
+ *  	that every holder can report it.
+ *
+ *  const char *inFileName - The name of the file to load.
+ *  int numThreads - The most threads to parse the file with, as for
+ *  	procReadTableParallel. Zero or less means one for every online
+ *  	processor.
+ *  int numRefs - The number of holders it will be handed to. Must be
+ *  	positive.
+ *
+ *  Returns a new workload. Each of its numRefs holders should call
+ *  	workloadRelease once when it has finished with it.
+ */
+Workload workloadLoad( const char *inFileName, int numThreads, int numRefs );
+
+
+/****
+ *  workloadRelease
+ *  Description: Gives up one reference to a workload, freeing it and its
+ *  	table if that was the last one.
+ *
+ *  Workload workload - The workload. Must be non-null.
+ *
+ *  Returns nothing.
+ */
+void workloadRelease( Workload workload );
+
+
+#endif
@@ -0,0 +1,700 @@
+/* bench.c
+ * Benchmarks for the core data structures and the
+ * simulation engines. The micro benchmarks time
+ * single operations on lists and gantt charts of
+ * 10^2 up to 10^7 items, and the end to end
+ * benchmarks time whole simulations of synthetic
+ * workloads of increasing size. Every size is run
+ * in its own child process so that its peak memory
+ * can be measured on its own. The results are
+ * written as one CSV table, so tables from two
+ * builds can be compared line by line.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include "../common.h"
+#include "../LList.h"
+#include "../Gantt.h"
+#include "../proc.h"
+#include "../ProcTable.h"
+#include "../rrsim.h"
+#include "../sjfsim.h"
+#include "../simcalc.h"
+
+/* The smallest and largest sizes run, as powers of ten */
+#define BENCH_MIN_EXP 2
+#define BENCH_MAX_EXP 7
+/* Each size is repeated until the timed part takes at least this long */
+#define BENCH_MIN_SECONDS 0.2
+#define BENCH_MAX_REPS ( 1 << 24 )
+
+/* The suites */
+#define BENCH_MICRO 0
+#define BENCH_E2E 1
+
+/* The quantum used for the synthetic workloads */
+#define BENCH_QUANTUM 4
+/* Bursts of the synthetic workloads are 1 to BENCH_MAX_BURST, and
+ * processes arrive 0 to BENCH_MAX_GAP apart. The mean gap is a little
+ * longer than the mean burst so the CPU is busy most of the time but the
+ * ready queue does not grow without bound */
+#define BENCH_MAX_BURST 19
+#define BENCH_MAX_GAP 21
+
+
+/* A benchmark.
+ * suite - BENCH_MICRO or BENCH_E2E.
+ * name - The name written to the table.
+ * run - Repeats the benchmark reps times on n items and returns the
+ * 	seconds spent in the part being measured. Setting up and tearing down
+ * 	is not counted. */
+struct benchmark
+{
+	int suite;
+	const char *name;
+	double (*run)( size_t n, int reps );
+};
+
+
+/* The names of the suites, as written to the table */
+static const char *suiteNames[] = { "micro", "e2e" };
+
+/* Written to by the benchmarks so that the compiler can not throw the
+ * work away */
+static volatile long benchSink;
+
+
+/****
+ *  benchNow
+ *  Description: Reads the monotonic clock.
+ *
+ *  Returns the time in seconds.
+ */
+static double benchNow( void )
+{
+	struct timespec now;
+
+	clock_gettime( CLOCK_MONOTONIC, &now );
+
+	return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+
+/****
+ *  benchRand
+ *  Description: A small xorshift generator. The benchmarks use their own
+ *  	generator with a fixed seed so every build is timed on exactly the
+ *  	same data.
+ *
+ *  unsigned long *state - The generator's state. Must not be zero.
+ *
+ *  Returns the next number, up to 2^32 - 1.
+ */
+static unsigned long benchRand( unsigned long *state )
+{
+	unsigned long x = *state;
+
+	x ^= ( x << 13 ) & 0xffffffffUL;
+	x ^= x >> 17;
+	x ^= ( x << 5 ) & 0xffffffffUL;
+	*state = x;
+
+	return x;
+}
+
+
+/****
+ *  benchWorkload
+ *  Description: Makes a synthetic workload, in order of arrival.
+ *
+ *  size_t n - The number of processes.
+ *
+ *  Returns an array of n processes. It should be freed with free.
+ */
+static struct proc *benchWorkload( size_t n )
+{
+	struct proc *procs;
+	unsigned long state = 12345;
+	int arrival = 0;
+	size_t i;
+
+	procs = malloc( ( n > 0 ? n : 1 ) * sizeof *procs );
+	for( i = 0; i < n; i++ )
+	{
+		procs[i].pNo = i + 1;
+		procs[i].arrivalTime = arrival;
+		procs[i].burstTime = 1 + benchRand( &state ) % BENCH_MAX_BURST;
+		arrival += benchRand( &state ) % ( BENCH_MAX_GAP + 1 );
+	}
+
+	return procs;
+}
+
+
+/****
+ *  benchList
+ *  Description: Makes a list that points at every process of an array.
+ *
+ *  struct proc *procs - The processes.
+ *  size_t n - The number of processes.
+ *
+ *  Returns the new list. It should be freed with listDestroy.
+ */
+static LList benchList( struct proc *procs, size_t n )
+{
+	LList list;
+	size_t i;
+
+	list = listCreate();
+	for( i = 0; i < n; i++ )
+	{
+		listAdd( list, &procs[i], i + 1 );
+	}
+
+	return list;
+}
+
+
+/* MICRO BENCHMARKS */
+
+/* Appends n items to an empty list */
+static double benchListAdd( size_t n, int reps )
+{
+	static int item;
+	double seconds = 0.0;
+	int rep;
+	size_t i;
+
+	for( rep = 0; rep < reps; rep++ )
+	{
+		LList list;
+		double start;
+
+		list = listCreate();
+		start = benchNow();
+		for( i = 0; i < n; i++ )
+		{
+			listAdd( list, &item, i + 1 );
+		}
+		seconds += benchNow() - start;
+		listDestroy( list );
+	}
+
+	return seconds;
+}
+
+
+/* Reads n items from random positions of a list of n items */
+static double benchListGet( size_t n, int reps )
+{
+	struct proc *procs;
+	int *positions;
+	LList list;
+	unsigned long state = 54321;
+	double seconds = 0.0;
+	int rep;
+	size_t i;
+
+	procs = benchWorkload( n );
+	list = benchList( procs, n );
+	positions = malloc( n * sizeof *positions );
+	for( i = 0; i < n; i++ )
+	{
+		positions[i] = 1 + benchRand( &state ) % n;
+	}
+
+	for( rep = 0; rep < reps; rep++ )
+	{
+		double start;
+		long sum = 0;
+
+		start = benchNow();
+		for( i = 0; i < n; i++ )
+		{
+			sum += ( (struct proc *)listGet( list, positions[i] ) )->burstTime;
+		}
+		seconds += benchNow() - start;
+		benchSink += sum;
+	}
+
+	free( positions );
+	listDestroy( list );
+	free( procs );
+
+	return seconds;
+}
+
+
+/* Sorts a list of n processes with random arrival times by arrival */
+static double benchListSort( size_t n, int reps )
+{
+	struct proc *procs;
+	unsigned long state = 99991;
+	double seconds = 0.0;
+	int rep;
+	size_t i;
+
+	procs = benchWorkload( n );
+	for( i = 0; i < n; i++ )
+	{
+		procs[i].arrivalTime = benchRand( &state ) % ( n * ( BENCH_MAX_GAP / 2 ) + 1 );
+	}
+
+	for( rep = 0; rep < reps; rep++ )
+	{
+		LList list;
+		double start;
+
+		list = benchList( procs, n );
+		start = benchNow();
+		listSort( list, rrCmp );
+		seconds += benchNow() - start;
+		listDestroy( list );
+	}
+
+	free( procs );
+
+	return seconds;
+}
+
+
+/* Adds one block for each of n processes to an empty chart */
+static double benchGanttAddBlock( size_t n, int reps )
+{
+	double seconds = 0.0;
+	int rep;
+	size_t i;
+
+	for( rep = 0; rep < reps; rep++ )
+	{
+		Gantt gantt;
+		double start;
+
+		gantt = ganttCreate( 0 );
+		start = benchNow();
+		for( i = 0; i < n; i++ )
+		{
+			ganttAddBlock( gantt, i + 1, 1 + i % BENCH_MAX_BURST );
+		}
+		seconds += benchNow() - start;
+		ganttDestroy( gantt );
+	}
+
+	return seconds;
+}
+
+
+/* Works out the average waiting time of n processes from a chart that
+ * runs each of them once, in order */
+static double benchCalcAveWait( size_t n, int reps )
+{
+	struct proc *procs;
+	LList list;
+	Gantt gantt;
+	double seconds = 0.0;
+	int rep;
+	size_t i;
+
+	procs = benchWorkload( n );
+	list = benchList( procs, n );
+	gantt = ganttCreate( procs[0].arrivalTime );
+	for( i = 0; i < n; i++ )
+	{
+		ganttAddBlock( gantt, procs[i].pNo, procs[i].burstTime );
+	}
+
+	for( rep = 0; rep < reps; rep++ )
+	{
+		double start;
+
+		start = benchNow();
+		benchSink += (long)calcAveWait( gantt, list );
+		seconds += benchNow() - start;
+	}
+
+	ganttDestroy( gantt );
+	listDestroy( list );
+	free( procs );
+
+	return seconds;
+}
+
+
+/* END TO END BENCHMARKS */
+
+/* Runs rrSim, gantt chart and all, on a list of n processes */
+static double benchRrSim( size_t n, int reps )
+{
+	struct proc *procs;
+	LList list;
+	double seconds = 0.0;
+	int rep;
+
+	procs = benchWorkload( n );
+	list = benchList( procs, n );
+	for( rep = 0; rep < reps; rep++ )
+	{
+		double aveWait, aveTurn, start;
+
+		start = benchNow();
+		rrSim( list, BENCH_QUANTUM, &aveWait, &aveTurn );
+		seconds += benchNow() - start;
+		benchSink += (long)aveWait;
+	}
+	listDestroy( list );
+	free( procs );
+
+	return seconds;
+}
+
+
+/* Runs sjfSim, gantt chart and all, on a list of n processes */
+static double benchSjfSim( size_t n, int reps )
+{
+	struct proc *procs;
+	LList list;
+	double seconds = 0.0;
+	int rep;
+
+	procs = benchWorkload( n );
+	list = benchList( procs, n );
+	for( rep = 0; rep < reps; rep++ )
+	{
+		double aveWait, aveTurn, start;
+
+		start = benchNow();
+		sjfSim( list, &aveWait, &aveTurn );
+		seconds += benchNow() - start;
+		benchSink += (long)aveWait;
+	}
+	listDestroy( list );
+	free( procs );
+
+	return seconds;
+}
+
+
+/****
+ *  benchTable
+ *  Description: Puts a synthetic workload in to a process table.
+ *
+ *  size_t n - The number of processes.
+ *
+ *  Returns the new table. It should be freed with ptDestroy.
+ */
+static ProcTable benchTable( size_t n )
+{
+	struct proc *procs;
+	ProcTable table;
+	size_t i;
+
+	procs = benchWorkload( n );
+	table = ptCreate( n, BENCH_QUANTUM );
+	for( i = 0; i < n; i++ )
+	{
+		ptAdd( table, procs[i].arrivalTime, procs[i].burstTime );
+	}
+	free( procs );
+
+	return table;
+}
+
+
+/* Runs rrSimTable on a table of n processes */
+static double benchRrSimTable( size_t n, int reps )
+{
+	ProcTable table;
+	double seconds = 0.0;
+	int rep;
+
+	table = benchTable( n );
+	for( rep = 0; rep < reps; rep++ )
+	{
+		double aveWait, aveTurn, start;
+
+		start = benchNow();
+		rrSimTable( table, BENCH_QUANTUM, &aveWait, &aveTurn );
+		seconds += benchNow() - start;
+		benchSink += (long)aveWait;
+	}
+	ptDestroy( table );
+
+	return seconds;
+}
+
+
+/* Runs sjfSimTable on a table of n processes */
+static double benchSjfSimTable( size_t n, int reps )
+{
+	ProcTable table;
+	double seconds = 0.0;
+	int rep;
+
+	table = benchTable( n );
+	for( rep = 0; rep < reps; rep++ )
+	{
+		double aveWait, aveTurn, start;
+
+		start = benchNow();
+		sjfSimTable( table, &aveWait, &aveTurn );
+		seconds += benchNow() - start;
+		benchSink += (long)aveWait;
+	}
+	ptDestroy( table );
+
+	return seconds;
+}
+
+
+/* Every benchmark, in the order they are run */
+static const struct benchmark benchmarks[] =
+{
+	{ BENCH_MICRO, "listAdd", benchListAdd },
+	{ BENCH_MICRO, "listGet", benchListGet },
+	{ BENCH_MICRO, "listSort", benchListSort },
+	{ BENCH_MICRO, "ganttAddBlock", benchGanttAddBlock },
+	{ BENCH_MICRO, "calcAveWait", benchCalcAveWait },
+	{ BENCH_E2E, "rrSim", benchRrSim },
+	{ BENCH_E2E, "sjfSim", benchSjfSim },
+	{ BENCH_E2E, "rrSimTable", benchRrSimTable },
+	{ BENCH_E2E, "sjfSimTable", benchSjfSimTable }
+};
+#define BENCH_NUM ( (int)( sizeof benchmarks / sizeof *benchmarks ) )
+
+
+/****
+ *  benchMeasure
+ *  Description: Times a benchmark at one size, doubling the number of
+ *  	repetitions until the timed part takes long enough to trust.
+ *
+ *  const struct benchmark *bench - The benchmark.
+ *  size_t n - The size.
+ *  int *outReps - Where to place the number of repetitions timed.
+ *
+ *  Returns the seconds taken by those repetitions.
+ */
+static double benchMeasure( const struct benchmark *bench, size_t n, int *outReps )
+{
+	double seconds;
+	int reps = 1;
+
+	seconds = bench->run( n, reps );
+	while( seconds < BENCH_MIN_SECONDS && reps < BENCH_MAX_REPS )
+	{
+		reps *= 2;
+		seconds = bench->run( n, reps );
+	}
+	*outReps = reps;
+
+	return seconds;
+}
+
+
+/****
+ *  benchChild
+ *  Description: Measures a benchmark at one size in a child process, so
+ *  	that the child's peak memory is that of this size alone.
+ *
+ *  const struct benchmark *bench - The benchmark.
+ *  size_t n - The size.
+ *  int *outReps - Where to place the number of repetitions timed.
+ *  double *outSeconds - Where to place the seconds they took.
+ *  long *outPeakKb - Where to place the child's peak resident set size, in
+ *  	kilobytes.
+ *
+ *  Returns TRUE if the child finished and reported its result.
+ */
+static int benchChild( const struct benchmark *bench, size_t n, int *outReps, double *outSeconds, long *outPeakKb )
+{
+	int fds[2];
+	pid_t pid;
+	int status;
+	struct rusage usage;
+	int ok = FALSE;
+
+	if( pipe( fds ) == 0 )
+	{
+		fflush( NULL );
+		pid = fork();
+		if( pid == 0 )
+		{
+			double seconds;
+			int reps;
+
+			close( fds[0] );
+			seconds = benchMeasure( bench, n, &reps );
+			if( write( fds[1], &reps, sizeof reps ) != sizeof reps ||
+				write( fds[1], &seconds, sizeof seconds ) != sizeof seconds )
+			{
+				_exit( 1 );
+			}
+			_exit( 0 );
+		}
+
+		close( fds[1] );
+		if( pid > 0 )
+		{
+			ok = ( read( fds[0], outReps, sizeof *outReps ) == sizeof *outReps &&
+				read( fds[0], outSeconds, sizeof *outSeconds ) == sizeof *outSeconds );
+			ok = ( wait4( pid, &status, 0, &usage ) == pid ) && ok &&
+				WIFEXITED( status ) && WEXITSTATUS( status ) == 0;
+			*outPeakKb = usage.ru_maxrss;
+		}
+		close( fds[0] );
+	}
+
+	return ok;
+}
+
+
+/****
+ *  benchRun
+ *  Description: Runs a benchmark at every size and writes a row of the
+ *  	table for each, followed by a row with the scaling exponent fitted to
+ *  	all of them. The exponent is the slope of log time against log size,
+ *  	so 1 means linear and 2 quadratic. Each row also has the exponent
+ *  	from the size before it alone.
+ *
+ *  const struct benchmark *bench - The benchmark.
+ *  int maxExp - The largest size, as a power of ten.
+ *  FILE *outFile - Where to write the rows.
+ *
+ *  Returns TRUE if every size ran.
+ */
+static int benchRun( const struct benchmark *bench, int maxExp, FILE *outFile )
+{
+	double sumX = 0.0, sumY = 0.0, sumXX = 0.0, sumXY = 0.0;
+	double lastX = 0.0, lastY = 0.0;
+	int numPoints = 0;
+	int ok = TRUE;
+	int exp;
+	size_t n = 1;
+
+	for( exp = 0; exp < BENCH_MIN_EXP; exp++ )
+	{
+		n *= 10;
+	}
+
+	for( exp = BENCH_MIN_EXP; ok && exp <= maxExp; exp++, n *= 10 )
+	{
+		int reps;
+		double seconds;
+		long peakKb;
+
+		ok = benchChild( bench, n, &reps, &seconds, &peakKb );
+		if( !ok )
+		{
+			fprintf( stderr, "%s failed at n=%lu\n", bench->name, (unsigned long)n );
+		}
+		else
+		{
+			double x = log( (double)n ), y = log( seconds / reps );
+
+			fprintf( outFile, "%s,%s,%lu,%d,%f,%f,%ld,", suiteNames[bench->suite], bench->name,
+				(unsigned long)n, reps, seconds, seconds / reps / n * 1e9, peakKb );
+			if( numPoints > 0 )
+			{
+				fprintf( outFile, "%f", ( y - lastY ) / ( x - lastX ) );
+			}
+			fprintf( outFile, "\n" );
+			fflush( outFile );
+
+			sumX += x;
+			sumY += y;
+			sumXX += x * x;
+			sumXY += x * y;
+			lastX = x;
+			lastY = y;
+			numPoints++;
+		}
+	}
+
+	if( numPoints > 1 )
+	{
+		fprintf( outFile, "%s,%s,fit,,,,,%f\n", suiteNames[bench->suite], bench->name,
+			( numPoints * sumXY - sumX * sumY ) / ( numPoints * sumXX - sumX * sumX ) );
+	}
+
+	return ok;
+}
+
+
+int main( int argc, char *argv[] )
+{
+	int maxExp = BENCH_MAX_EXP;
+	int runSuite[2] = { TRUE, TRUE };
+	const char *outFileName = NULL;
+	FILE *outFile = stdout;
+	int valid = TRUE;
+	int opt;
+	int error = 0;
+
+	/* -m and -e pick one suite. -x sets the largest size */
+	while( ( opt = getopt( argc, argv, "mex:o:" ) ) != -1 )
+	{
+		if( opt == 'm' )
+		{
+			runSuite[BENCH_E2E] = FALSE;
+		}
+		else if( opt == 'e' )
+		{
+			runSuite[BENCH_MICRO] = FALSE;
+		}
+		else if( opt == 'x' )
+		{
+			maxExp = atoi( optarg );
+			valid = valid && maxExp >= BENCH_MIN_EXP && maxExp <= BENCH_MAX_EXP;
+		}
+		else if( opt == 'o' )
+		{
+			outFileName = optarg;
+		}
+		else
+		{
+			valid = FALSE;
+		}
+	}
+
+	if( !valid || optind < argc )
+	{
+		fprintf( stderr, "Usage: %s [-m | -e] [-x max] [-o out.csv]\n"
+			"  -m runs only the micro benchmarks and -e only the end to end ones.\n"
+			"  Sizes run from 10^%d to 10^max, where max is at most %d.\n",
+			argv[0], BENCH_MIN_EXP, BENCH_MAX_EXP );
+		error = 1;
+	}
+	else if( outFileName != NULL && ( outFile = fopen( outFileName, "w" ) ) == NULL )
+	{
+		fprintf( stderr, "Can not open file: %s\n", outFileName );
+		error = 1;
+	}
+	else
+	{
+		int i;
+
+		fprintf( outFile, "suite,benchmark,n,reps,seconds,ns_per_item,peak_rss_kb,exponent\n" );
+		for( i = 0; i < BENCH_NUM; i++ )
+		{
+			if( runSuite[benchmarks[i].suite] && !benchRun( &benchmarks[i], maxExp, outFile ) )
+			{
+				error = 1;
+			}
+		}
+
+		if( outFile != stdout )
+		{
+			fclose( outFile );
+		}
+	}
+
+	return error;
+}
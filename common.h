@@ -9,8 +9,38 @@
 /* Assertions to catch bugs, not errors. */
 #include <assert.h>
 #include <stddef.h>
+#include <stdint.h>
 
 #define TRUE (1)
 #define FALSE (!TRUE)
 
+/* The type of every simulated time and duration, and of the sums of them
+ * the metrics are built from. 64 bits, so neither the clock nor a total
+ * over tens of millions of processes can overflow */
+typedef int64_t simTime;
+
+/* Selects the contiguous array backend for the LList module. Appending and
+ * indexed access are O(1) with this backend. Remove this definition to go
+ * back to the singly-linked backend. */
+#define LLIST_ARRAY
+
+/* Has the simulations count what they do, in the struct simStats of their
+ * results. Remove this definition and every counter is compiled out, so
+ * the simulations cost exactly what they did before the counters. */
+#define SIM_STATS
+
+/* Wraps a statement that only counts something, so it goes away when
+ * SIM_STATS is not defined */
+#ifdef SIM_STATS
+#define SIM_STAT( statement ) statement
+#else
+#define SIM_STAT( statement )
+#endif
+
+#ifdef SIM_STATS
+/* The number of heap allocations the calling thread has made through the
+ * modules the simulations use. Defined in Arena.c */
+extern _Thread_local long simAllocs;
+#endif
+
 #endif
@@ -0,0 +1,52 @@
+/* conv.c
+ * Converts a text workload file in to the binary
+ * workload format, which the simulators load
+ * without parsing.
+ */
+
+#include <stdio.h>
+#include "../common.h"
+#include "../proc.h"
+
+int main( int argc, char *argv[] )
+{
+	int error = 0;
+
+	if( argc != 3 )
+	{
+		fprintf( stderr, "Usage: %s <input file> <output file>\n", argv[0] );
+		error = 1;
+	}
+	else
+	{
+		ProcTable procTable;
+		int fileError;
+		size_t errLine;
+
+		/* Read the workload. Binary files are accepted too */
+		fileError = procReadTableParallel( argv[1], 0, &procTable, &errLine );
+
+		if( fileError == PROC_NO_OPEN )
+		{
+			fprintf( stderr, "Can not open file: %s\n", argv[1] );
+			error = 1;
+		}
+		else if( fileError == PROC_BAD_FORMAT )
+		{
+			fprintf( stderr, "File is not formatted properly! (line %lu)\n", (unsigned long)errLine );
+			error = 1;
+		}
+		else
+		{
+			if( procWriteBinary( argv[2], procTable ) != PROC_NO_ERROR )
+			{
+				fprintf( stderr, "Can not write file: %s\n", argv[2] );
+				error = 1;
+			}
+
+			ptDestroy( procTable );
+		}
+	}
+
+	return error;
+}
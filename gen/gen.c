@@ -0,0 +1,283 @@
+/* gen.c
+ * Generates a synthetic workload of any size and
+ * writes it straight to a file in the text or the
+ * binary workload format. Processes are written as
+ * they are drawn, so nothing the size of the
+ * workload is ever held in memory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "../common.h"
+#include "../proc.h"
+#include "../Generator.h"
+
+/* The defaults for the options */
+#define GEN_DEFAULT_QUANTUM 4
+#define GEN_DEFAULT_MEAN 10.0
+#define GEN_DEFAULT_UTILISATION 0.9
+#define GEN_DEFAULT_BURSTINESS 10.0
+#define GEN_DEFAULT_DWELL 100.0
+#define GEN_DEFAULT_SHAPE 1.5
+
+/* The size of the output buffer, and of the column buffer for binary files */
+#define GEN_OUT_BUF ( 1 << 20 )
+#define GEN_COLUMN_BUF 4096
+
+
+/* What was written, to report to the user.
+ * count - The number of processes written.
+ * lastArrival - The arrival time of the last of them.
+ * totalBurst - The sum of their burst times. */
+struct genTotals
+{
+	size_t count;
+	simTime lastArrival;
+	simTime totalBurst;
+};
+
+
+/****
+ *  genWriteText
+ *  Description: Writes a workload in the text format, one process per line.
+ *
+ *  FILE *outFile - The file to write to.
+ *  Generator gen - The generator, just rewound.
+ *  int quantum - The quantum for the first line.
+ *  size_t count - The number of processes.
+ *  struct genTotals *outTotals - Where to place what was written.
+ *
+ *  Returns TRUE if every process was written, FALSE if the file could not
+ *  	be written or the arrivals ran past the largest simTime.
+ */
+static int genWriteText( FILE *outFile, Generator gen, int quantum, size_t count, struct genTotals *outTotals )
+{
+	int success;
+	size_t i;
+
+	success = ( fprintf( outFile, "%d\n", quantum ) > 0 );
+	for( i = 0; success && i < count; i++ )
+	{
+		simTime arrival, burst;
+
+		arrival = genNextArrival( gen );
+		burst = genNextBurst( gen );
+		success = ( arrival >= 0 && fprintf( outFile, "%lld\t%lld\n", (long long)arrival, (long long)burst ) > 0 );
+		if( success )
+		{
+			outTotals->count++;
+			outTotals->lastArrival = arrival;
+			outTotals->totalBurst += burst;
+		}
+	}
+
+	return success;
+}
+
+
+/****
+ *  genWriteBinary
+ *  Description: Writes a workload in the binary format. The arrival column
+ *  	is drawn and written first and then the burst column, which the
+ *  	generator's separate arrival and burst streams make the same as
+ *  	drawing them in pairs.
+ *
+ *  FILE *outFile, Generator gen, int quantum, size_t count,
+ *  struct genTotals *outTotals - As for genWriteText.
+ *
+ *  Returns as for genWriteText.
+ */
+static int genWriteBinary( FILE *outFile, Generator gen, int quantum, size_t count, struct genTotals *outTotals )
+{
+	int64_t buf[GEN_COLUMN_BUF];
+	size_t numBuf = 0;
+	int success;
+	size_t i;
+
+	/* Arrivals are generated in order, so the file is always sorted */
+	success = procWriteBinaryHeader( outFile, quantum, count, TRUE );
+	for( i = 0; success && i < count; i++ )
+	{
+		buf[numBuf] = genNextArrival( gen );
+		success = ( buf[numBuf] >= 0 );
+		outTotals->lastArrival = buf[numBuf];
+		numBuf++;
+		if( success && ( numBuf == GEN_COLUMN_BUF || i + 1 == count ) )
+		{
+			success = ( fwrite( buf, sizeof *buf, numBuf, outFile ) == numBuf );
+			numBuf = 0;
+		}
+	}
+
+	for( i = 0; success && i < count; i++ )
+	{
+		buf[numBuf] = genNextBurst( gen );
+		outTotals->totalBurst += buf[numBuf];
+		numBuf++;
+		if( numBuf == GEN_COLUMN_BUF || i + 1 == count )
+		{
+			success = ( fwrite( buf, sizeof *buf, numBuf, outFile ) == numBuf );
+			numBuf = 0;
+		}
+	}
+	if( success )
+	{
+		outTotals->count = count;
+	}
+
+	return success;
+}
+
+
+int main( int argc, char *argv[] )
+{
+	struct genConfig config;
+	struct genTotals totals;
+	int quantum = GEN_DEFAULT_QUANTUM;
+	int binary = FALSE;
+	int valid = TRUE;
+	int error = 0;
+	long long count = 0;
+	int opt;
+
+	config.arrivals = GEN_ARRIVE_POISSON;
+	config.bursts = GEN_BURST_EXP;
+	config.meanBurst = GEN_DEFAULT_MEAN;
+	config.utilisation = GEN_DEFAULT_UTILISATION;
+	config.numCpus = 1;
+	config.burstiness = GEN_DEFAULT_BURSTINESS;
+	config.dwell = GEN_DEFAULT_DWELL;
+	config.paretoShape = GEN_DEFAULT_SHAPE;
+	config.seed = 1;
+
+	while( ( opt = getopt( argc, argv, "a:b:m:u:n:k:d:p:s:q:B" ) ) != -1 )
+	{
+		if( opt == 'a' )
+		{
+			config.arrivals = genArrivalFromName( optarg );
+			valid = valid && config.arrivals >= 0;
+		}
+		else if( opt == 'b' )
+		{
+			config.bursts = genBurstFromName( optarg );
+			valid = valid && config.bursts >= 0;
+		}
+		else if( opt == 'm' )
+		{
+			config.meanBurst = atof( optarg );
+			valid = valid && config.meanBurst >= 1.0;
+		}
+		else if( opt == 'u' )
+		{
+			config.utilisation = atof( optarg );
+			valid = valid && config.utilisation > 0.0;
+		}
+		else if( opt == 'n' )
+		{
+			config.numCpus = atoi( optarg );
+			valid = valid && config.numCpus > 0;
+		}
+		else if( opt == 'k' )
+		{
+			config.burstiness = atof( optarg );
+			valid = valid && config.burstiness >= 1.0;
+		}
+		else if( opt == 'd' )
+		{
+			config.dwell = atof( optarg );
+			valid = valid && config.dwell > 0.0;
+		}
+		else if( opt == 'p' )
+		{
+			config.paretoShape = atof( optarg );
+			valid = valid && config.paretoShape > 1.0;
+		}
+		else if( opt == 's' )
+		{
+			config.seed = strtoull( optarg, NULL, 10 );
+		}
+		else if( opt == 'q' )
+		{
+			quantum = atoi( optarg );
+			valid = valid && quantum > 0;
+		}
+		else if( opt == 'B' )
+		{
+			binary = TRUE;
+		}
+		else
+		{
+			valid = FALSE;
+		}
+	}
+
+	if( optind + 2 == argc )
+	{
+		count = atoll( argv[optind] );
+	}
+
+	if( !valid || optind + 2 != argc || count <= 0 )
+	{
+		fprintf( stderr, "Usage: %s [-a poisson|mmpp] [-b exp|bimodal|pareto] [-m mean burst]\n"
+			"       [-u utilisation] [-n cpus] [-k burstiness] [-d dwell] [-p shape]\n"
+			"       [-s seed] [-q quantum] [-B] <count> <output file>\n"
+			"  Writes count processes, in the binary format with -B. The output\n"
+			"  file may be - for stdout.\n", argv[0] );
+		error = 1;
+	}
+	else
+	{
+		FILE *outFile;
+
+		if( strcmp( argv[optind + 1], "-" ) == 0 )
+		{
+			outFile = stdout;
+		}
+		else
+		{
+			outFile = fopen( argv[optind + 1], binary ? "wb" : "w" );
+		}
+
+		if( outFile == NULL )
+		{
+			fprintf( stderr, "Can not open file: %s\n", argv[optind + 1] );
+			error = 1;
+		}
+		else
+		{
+			Generator gen;
+			int success;
+
+			setvbuf( outFile, NULL, _IOFBF, GEN_OUT_BUF );
+			gen = genCreate( &config );
+			memset( &totals, 0, sizeof totals );
+			if( binary )
+			{
+				success = genWriteBinary( outFile, gen, quantum, count, &totals );
+			}
+			else
+			{
+				success = genWriteText( outFile, gen, quantum, count, &totals );
+			}
+			genDestroy( gen );
+
+			/* A failed close means buffered data was lost */
+			if( fclose( outFile ) != 0 || !success )
+			{
+				fprintf( stderr, "Can not write file: %s (after %lu processes)\n",
+					argv[optind + 1], (unsigned long)totals.count );
+				error = 1;
+			}
+			else
+			{
+				fprintf( stderr, "%lu processes, %s arrivals, %s bursts, offered utilisation %f\n",
+					(unsigned long)totals.count, genArrivalName( config.arrivals ), genBurstName( config.bursts ),
+					(double)totals.totalBurst / ( (double)config.numCpus * ( (double)totals.lastArrival + 1.0 ) ) );
+			}
+		}
+	}
+
+	return error;
+}
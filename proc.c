@@ -1,10 +1,47 @@
+#include <fcntl.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include "proc.h"
 
 
+/* The most threads procReadTableParallel will parse with */
+#define PROC_MAX_THREADS 64
+/* The least a thread is given to parse. Smaller files are not worth
+ * splitting */
+#define PROC_MIN_CHUNK ( 1 << 20 )
+/* Past this an integer can not take another digit without passing the
+ * largest simTime. At it, only digits up to INT64_MAX % 10 still fit */
+#define PROC_SCAN_LIMIT ( INT64_MAX / 10 )
+
+
+/* A piece of a file parsed by one thread of procReadTableParallel.
+ * start, end - The piece. It starts at the start of a line and ends just
+ * 	after a newline, or at the end of the file.
+ * arrival, burst - The processes read from the piece.
+ * count - The number of processes read.
+ * numLines - The number of lines read. If an error occurred this is the
+ * 	line within the piece that caused it.
+ * error - PROC_NO_ERROR or PROC_BAD_FORMAT. */
+struct procChunk
+{
+	const char *start;
+	const char *end;
+	simTime *arrival;
+	simTime *burst;
+	size_t count;
+	size_t numLines;
+	int error;
+};
+
+
 int procReadFile( const char *inFileName, LList outList, int *outQuantum )
 {
 	FILE *inFile;
-	int arrTime, bstTime;
+	simTime arrTime, bstTime;
 	int procNum;
 	int error = PROC_NO_ERROR;
 
@@ -21,12 +58,13 @@ int procReadFile( const char *inFileName, LList outList, int *outQuantum )
 			/* Loop through our file line by line and read the data
 			 * for each process */
 			procNum = 1;
-			while( fscanf( inFile, "%d %d\n", &arrTime, &bstTime ) == 2 )
+			while( fscanf( inFile, "%" SCNd64 " %" SCNd64 "\n", &arrTime, &bstTime ) == 2 )
 			{
 				struct proc *newProc;
 
-				/* Create/initialise process and add to our list */
-				newProc = malloc( sizeof *newProc );
+				/* Create/initialise process and add to our list. It
+				 * lives in the list's arena */
+				newProc = listAlloc( outList, sizeof *newProc );
 				newProc->pNo = procNum;
 				newProc->arrivalTime = arrTime;
 				newProc->burstTime = bstTime;
@@ -56,4 +94,564 @@ int procReadFile( const char *inFileName, LList outList, int *outQuantum )
 
 	return error;
 }
-			
+
+
+
+/****
+ *  procScanInt
+ *  Description: Reads a decimal integer, with an optional sign, from the
+ *  	start of a buffer. The integer must be followed by whitespace or the
+ *  	end of the buffer.
+ *
+ *  const char **pos - The position to read from. Advanced past the integer
+ *  	if one was read.
+ *  const char *end - The end of the buffer.
+ *  simTime *outValue - Where to place the integer.
+ *
+ *  Returns TRUE if an integer that fits in a simTime was read, FALSE
+ *  	otherwise. -INT64_MAX is the most negative integer accepted.
+ */
+static int procScanInt( const char **pos, const char *end, simTime *outValue )
+{
+	const char *p = *pos;
+	simTime value = 0;
+	int negative = FALSE;
+	int valid;
+
+	if( p < end && ( *p == '-' || *p == '+' ) )
+	{
+		negative = ( *p == '-' );
+		p++;
+	}
+
+	/* At least one digit is needed */
+	valid = ( p < end && *p >= '0' && *p <= '9' );
+	while( valid && p < end && *p >= '0' && *p <= '9' )
+	{
+		int digit = *p - '0';
+
+		/* Stop before the value overflows rather than after */
+		valid = ( value < PROC_SCAN_LIMIT || ( value == PROC_SCAN_LIMIT && digit <= INT64_MAX % 10 ) );
+		if( valid )
+		{
+			value = value * 10 + digit;
+			p++;
+		}
+	}
+
+	valid = valid && ( p == end || *p == ' ' || *p == '\t' || *p == '\r' || *p == '\n' );
+	if( valid )
+	{
+		*outValue = negative ? -value : value;
+		*pos = p;
+	}
+
+	return valid;
+}
+
+
+int procScanLine( const char **pos, const char *end, simTime *values )
+{
+	const char *p = *pos;
+	int numValues = 0;
+
+	while( numValues >= 0 && p < end && *p != '\n' )
+	{
+		if( *p == ' ' || *p == '\t' || *p == '\r' )
+		{
+			p++;
+		}
+		else if( numValues == PROC_MAX_FIELDS || !procScanInt( &p, end, &values[numValues] ) )
+		{
+			numValues = -1;
+		}
+		else
+		{
+			numValues++;
+		}
+	}
+
+	/* Step over the newline */
+	*pos = ( p < end ) ? p + 1 : p;
+
+	return numValues;
+}
+
+
+/****
+ *  procScanTable
+ *  Description: Parses a whole file held in memory in to a process table.
+ *
+ *  const char *buf - The contents of the file.
+ *  size_t len - The length of the file.
+ *  ProcTable *outTable - Where to place the new table if no error occurs.
+ *  size_t *outLine - Where to place the number of the offending line if the
+ *  	format is wrong.
+ *
+ *  Returns PROC_NO_ERROR or PROC_BAD_FORMAT.
+ */
+static int procScanTable( const char *buf, size_t len, ProcTable *outTable, size_t *outLine )
+{
+	const char *pos = buf, *end = buf + len;
+	const char *nl;
+	size_t numLines = 1;
+	simTime values[PROC_MAX_FIELDS];
+	int numValues = 0;
+	size_t line = 0;
+	int error = PROC_NO_ERROR;
+
+	/* Skip any blank lines and read the quantum */
+	while( numValues == 0 && pos < end )
+	{
+		line++;
+		numValues = procScanLine( &pos, end, values );
+	}
+
+	if( numValues == 1 && PROC_VALID_QUANTUM( values[0] ) )
+	{
+		ProcTable table;
+
+		/* There can be no more processes than lines left, so counting the
+		 * newlines gives a size for the table that never has to grow */
+		for( nl = memchr( pos, '\n', end - pos ); nl != NULL; nl = memchr( nl + 1, '\n', end - nl - 1 ) )
+		{
+			numLines++;
+		}
+		table = ptCreate( numLines, values[0] );
+
+		/* Loop through the rest of the buffer line by line and read the
+		 * data for each process */
+		while( error == PROC_NO_ERROR && pos < end )
+		{
+			line++;
+			numValues = procScanLine( &pos, end, values );
+			if( numValues == PROC_MAX_FIELDS )
+			{
+				ptAdd( table, values[0], values[1] );
+			}
+			else if( numValues != 0 ) /* Fields not formatted properly */
+			{
+				error = PROC_BAD_FORMAT;
+			}
+		}
+
+		if( error == PROC_NO_ERROR )
+		{
+			*outTable = table;
+		}
+		else
+		{
+			ptDestroy( table );
+		}
+	}
+	else /* Could not read quantum */
+	{
+		error = PROC_BAD_FORMAT;
+	}
+
+	*outLine = ( error == PROC_NO_ERROR ) ? 0 : ( line > 0 ? line : 1 );
+
+	return error;
+}
+
+
+/****
+ *  procScanChunk
+ *  Description: The thread function for procReadTableParallel. Parses one
+ *  	piece of the file in to its own columns. It is also called directly
+ *  	for a piece whose thread could not be started.
+ *
+ *  void *arg - The struct procChunk to parse.
+ *
+ *  Returns NULL. The results are left in the chunk.
+ */
+static void *procScanChunk( void *arg )
+{
+	struct procChunk *chunk = arg;
+	const char *pos = chunk->start;
+	const char *nl;
+	size_t numLines = 1;
+	simTime values[PROC_MAX_FIELDS];
+	int numValues;
+
+	/* There can be no more processes than lines in the piece */
+	for( nl = memchr( pos, '\n', chunk->end - pos ); nl != NULL; nl = memchr( nl + 1, '\n', chunk->end - nl - 1 ) )
+	{
+		numLines++;
+	}
+	chunk->arrival = malloc( numLines * sizeof *chunk->arrival );
+	chunk->burst = malloc( numLines * sizeof *chunk->burst );
+	chunk->count = 0;
+	chunk->numLines = 0;
+	chunk->error = PROC_NO_ERROR;
+
+	while( chunk->error == PROC_NO_ERROR && pos < chunk->end )
+	{
+		chunk->numLines++;
+		numValues = procScanLine( &pos, chunk->end, values );
+		if( numValues == PROC_MAX_FIELDS )
+		{
+			chunk->arrival[chunk->count] = values[0];
+			chunk->burst[chunk->count] = values[1];
+			chunk->count++;
+		}
+		else if( numValues != 0 ) /* Fields not formatted properly */
+		{
+			chunk->error = PROC_BAD_FORMAT;
+		}
+	}
+
+	return NULL;
+}
+
+
+/****
+ *  procScanParallel
+ *  Description: Parses a whole file held in memory in to a process table,
+ *  	as procScanTable does, using several threads. The quantum is read
+ *  	first. The rest of the file is then split in to one piece per thread,
+ *  	each piece ending at a newline, and the pieces are parsed at the same
+ *  	time. Their processes are then joined together in file order, so the
+ *  	process numbers are as if the file was read from top to bottom.
+ *
+ *  const char *buf - The contents of the file.
+ *  size_t len - The length of the file.
+ *  int numThreads - The most threads to use.
+ *  ProcTable *outTable - Where to place the new table if no error occurs.
+ *  size_t *outLine - Where to place the number of the offending line if the
+ *  	format is wrong. This is the first bad line in the file, whichever
+ *  	thread found it.
+ *
+ *  Returns PROC_NO_ERROR or PROC_BAD_FORMAT.
+ */
+static int procScanParallel( const char *buf, size_t len, int numThreads, ProcTable *outTable, size_t *outLine )
+{
+	const char *pos = buf, *end = buf + len;
+	struct procChunk chunks[PROC_MAX_THREADS];
+	pthread_t threads[PROC_MAX_THREADS];
+	simTime values[PROC_MAX_FIELDS];
+	int numValues = 0;
+	int numChunks, numStarted, i;
+	size_t line = 0;
+	int error = PROC_NO_ERROR;
+
+	/* Skip any blank lines and read the quantum */
+	while( numValues == 0 && pos < end )
+	{
+		line++;
+		numValues = procScanLine( &pos, end, values );
+	}
+
+	/* Not worth splitting */
+	numChunks = ( end - pos ) / PROC_MIN_CHUNK;
+	if( numChunks > numThreads )
+	{
+		numChunks = numThreads;
+	}
+
+	if( numValues != 1 || !PROC_VALID_QUANTUM( values[0] ) || numChunks < 2 )
+	{
+		error = procScanTable( buf, len, outTable, &line );
+	}
+	else
+	{
+		size_t numProcs = 0;
+
+		/* Split the rest of the file in to pieces of about the same size,
+		 * moving each split forward to just after a newline */
+		for( i = 0; i < numChunks; i++ )
+		{
+			const char *split, *nl;
+
+			chunks[i].start = ( i == 0 ) ? pos : chunks[i - 1].end;
+			split = pos + ( end - pos ) / numChunks * ( i + 1 );
+			if( split < chunks[i].start )
+			{
+				split = chunks[i].start;
+			}
+			nl = ( i < numChunks - 1 ) ? memchr( split, '\n', end - split ) : NULL;
+			chunks[i].end = ( nl != NULL ) ? nl + 1 : end;
+		}
+
+		/* Pieces whose thread could not be started are parsed here, one
+		 * after another, and only the threads that started are joined */
+		numStarted = 0;
+		while( numStarted < numChunks && pthread_create( &threads[numStarted], NULL, procScanChunk, &chunks[numStarted] ) == 0 )
+		{
+			numStarted++;
+		}
+		for( i = numStarted; i < numChunks; i++ )
+		{
+			procScanChunk( &chunks[i] );
+		}
+		for( i = 0; i < numStarted; i++ )
+		{
+			pthread_join( threads[i], NULL );
+		}
+
+		/* Find the first error in file order. Until then every piece adds
+		 * its lines to the line count */
+		for( i = 0; i < numChunks && error == PROC_NO_ERROR; i++ )
+		{
+			line += chunks[i].numLines;
+			numProcs += chunks[i].count;
+			error = chunks[i].error;
+		}
+
+		if( error == PROC_NO_ERROR )
+		{
+			*outTable = ptCreate( numProcs, values[0] );
+			for( i = 0; i < numChunks; i++ )
+			{
+				ptAppend( *outTable, chunks[i].arrival, chunks[i].burst, chunks[i].count );
+			}
+			line = 0;
+		}
+
+		for( i = 0; i < numChunks; i++ )
+		{
+			free( chunks[i].arrival );
+			free( chunks[i].burst );
+		}
+	}
+
+	*outLine = line;
+
+	return error;
+}
+
+
+/****
+ *  procMapBinary
+ *  Description: Checks a mapped binary workload file and creates a table
+ *  	whose columns point in to the mapping. The columns of an older file
+ *  	are too narrow to use where they lie, so they are copied in to a new
+ *  	table instead.
+ *
+ *  void *map - The mapped file. The table takes it over if its columns
+ *  	point in to it, and otherwise it is unmapped.
+ *  size_t len - The length of the file.
+ *  ProcTable *outTable - Where to place the new table.
+ *
+ *  Returns PROC_NO_ERROR, or PROC_BAD_FORMAT if the header is not valid or
+ *  	the file is too short for its columns.
+ */
+static int procMapBinary( void *map, size_t len, ProcTable *outTable )
+{
+	const struct procBinHeader *header = map;
+	int error = PROC_BAD_FORMAT;
+
+	if( header->version == PROC_BIN_VERSION &&
+		header->count <= ( len - sizeof *header ) / ( 2 * sizeof( simTime ) ) )
+	{
+		const simTime *arrival = (const simTime *)( header + 1 );
+		int sorted = ( header->flags & PROC_BIN_SORTED ) != 0;
+		size_t i;
+
+		/* The flag is only a claim made by whoever wrote the file. One pass
+		 * over the arrivals costs far less than paging them in, and an
+		 * unsorted table is simply sorted when it is simulated */
+		for( i = 1; sorted && i < header->count; i++ )
+		{
+			sorted = ( arrival[i] >= arrival[i - 1] );
+		}
+
+		*outTable = ptCreateMapped( arrival, arrival + header->count, header->count, header->quantum,
+			sorted, map, len );
+		error = PROC_NO_ERROR;
+	}
+	else if( header->version == PROC_BIN_VERSION_INT32 &&
+		header->count <= ( len - sizeof *header ) / ( 2 * sizeof( int32_t ) ) )
+	{
+		const int32_t *arrival = (const int32_t *)( header + 1 );
+		const int32_t *burst = arrival + header->count;
+		size_t i;
+
+		*outTable = ptCreate( header->count, header->quantum );
+		for( i = 0; i < header->count; i++ )
+		{
+			ptAdd( *outTable, arrival[i], burst[i] );
+		}
+		munmap( map, len );
+		error = PROC_NO_ERROR;
+	}
+	else
+	{
+		munmap( map, len );
+	}
+
+	return error;
+}
+
+
+/****
+ *  procLoad
+ *  Description: Does the work of procReadTable and procReadTableParallel.
+ *
+ *  const char *inFileName, ProcTable *outTable, size_t *outLine - As for
+ *  	procReadTable.
+ *  int numThreads - The most threads to parse a text file with.
+ *
+ *  Returns an error code as for procReadFile.
+ */
+static int procLoad( const char *inFileName, int numThreads, ProcTable *outTable, size_t *outLine )
+{
+	int inFile;
+	struct stat info;
+	size_t line = 0;
+	int error;
+
+	assert( outTable != NULL );
+
+	/* Attempt to open the given file and find out its size */
+	inFile = open( inFileName, O_RDONLY );
+	if( inFile < 0 || fstat( inFile, &info ) != 0 )
+	{
+		error = PROC_NO_OPEN;
+	}
+	else if( info.st_size == 0 ) /* Could not read quantum */
+	{
+		line = 1;
+		error = PROC_BAD_FORMAT;
+	}
+	else
+	{
+		void *map;
+
+		/* Map the file rather than reading it so the scanner works
+		 * straight from the page cache */
+		map = mmap( NULL, info.st_size, PROT_READ, MAP_PRIVATE, inFile, 0 );
+		if( map == MAP_FAILED )
+		{
+			error = PROC_NO_OPEN;
+		}
+		else if( info.st_size >= sizeof( struct procBinHeader ) &&
+			memcmp( map, PROC_BIN_MAGIC, sizeof( ((struct procBinHeader *)0)->magic ) ) == 0 )
+		{
+			/* A binary file. The table may keep the mapping */
+			error = procMapBinary( map, info.st_size, outTable );
+		}
+		else
+		{
+			if( numThreads > 1 )
+			{
+				error = procScanParallel( map, info.st_size, numThreads, outTable, &line );
+			}
+			else
+			{
+				madvise( map, info.st_size, MADV_SEQUENTIAL );
+				error = procScanTable( map, info.st_size, outTable, &line );
+			}
+			munmap( map, info.st_size );
+		}
+	}
+
+	if( inFile >= 0 )
+	{
+		close( inFile );
+	}
+	if( outLine != NULL )
+	{
+		*outLine = line;
+	}
+
+	return error;
+}
+
+
+int procReadTable( const char *inFileName, ProcTable *outTable, size_t *outLine )
+{
+	return procLoad( inFileName, 1, outTable, outLine );
+}
+
+
+int procReadTableParallel( const char *inFileName, int numThreads, ProcTable *outTable, size_t *outLine )
+{
+	/* Use every processor unless told otherwise */
+	if( numThreads <= 0 )
+	{
+		numThreads = sysconf( _SC_NPROCESSORS_ONLN );
+	}
+	if( numThreads > PROC_MAX_THREADS )
+	{
+		numThreads = PROC_MAX_THREADS;
+	}
+
+	return procLoad( inFileName, numThreads, outTable, outLine );
+}
+
+
+/****
+ *  procWriteColumn
+ *  Description: Writes one column of a process table to a file.
+ *
+ *  FILE *outFile - The file to write to.
+ *  ProcTable table - The table.
+ *  simTime (*get)( ProcTable, size_t ) - ptArrival or ptBurst.
+ *
+ *  Returns TRUE if every value was written.
+ */
+static int procWriteColumn( FILE *outFile, ProcTable table, simTime (*get)( ProcTable table, size_t pNo ) )
+{
+	int64_t buf[4096];
+	size_t pNo, numBuf = 0;
+	int success = TRUE;
+
+	/* Values are gathered in to a buffer and written a buffer at a time */
+	for( pNo = 1; success && pNo <= ptSize( table ); pNo++ )
+	{
+		buf[numBuf++] = get( table, pNo );
+		if( numBuf == sizeof buf / sizeof *buf || pNo == ptSize( table ) )
+		{
+			success = ( fwrite( buf, sizeof *buf, numBuf, outFile ) == numBuf );
+			numBuf = 0;
+		}
+	}
+
+	return success;
+}
+
+
+int procWriteBinary( const char *outFileName, ProcTable table )
+{
+	FILE *outFile;
+	int error = PROC_NO_OPEN;
+
+	assert( table != NULL );
+
+	outFile = fopen( outFileName, "wb" );
+	if( outFile != NULL )
+	{
+		if( procWriteBinaryHeader( outFile, ptQuantum( table ), ptSize( table ), ptSorted( table ) ) &&
+			procWriteColumn( outFile, table, ptArrival ) &&
+			procWriteColumn( outFile, table, ptBurst ) )
+		{
+			error = PROC_NO_ERROR;
+		}
+
+		/* A failed close means buffered data was lost */
+		if( fclose( outFile ) != 0 )
+		{
+			error = PROC_NO_OPEN;
+		}
+	}
+
+	return error;
+}
+
+
+int procWriteBinaryHeader( FILE *outFile, int quantum, uint64_t count, int sorted )
+{
+	struct procBinHeader header;
+
+	assert( outFile != NULL );
+
+	memset( &header, 0, sizeof header );
+	memcpy( header.magic, PROC_BIN_MAGIC, sizeof header.magic );
+	header.version = PROC_BIN_VERSION;
+	header.flags = sorted ? PROC_BIN_SORTED : 0;
+	header.quantum = quantum;
+	header.count = count;
+
+	return fwrite( &header, sizeof header, 1, outFile ) == 1;
+}
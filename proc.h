@@ -14,14 +14,57 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <limits.h>
 #include "common.h"
 #include "LList.h"
+#include "ProcTable.h"
 
 /* Error codes for our procReadFile function. These assist in giving
  * more detailed error messages to the user */
 #define PROC_NO_ERROR 0
 #define PROC_NO_OPEN -1
 #define PROC_BAD_FORMAT -2
+/* Only reported when reading a stream of processes, which must already be
+ * in order of arrival */
+#define PROC_NOT_SORTED -3
+
+/* The most integers procScanLine will ever be asked to read from a line */
+#define PROC_MAX_FIELDS 2
+
+/* Times are read as simTime but the quantum is kept as an int, so a
+ * quantum read from a file has to fit in one */
+#define PROC_VALID_QUANTUM( value ) ( (value) >= INT_MIN && (value) <= INT_MAX )
+
+
+/* The binary workload format. A file starts with a struct procBinHeader,
+ * followed by a column of count arrival times and then a column of count
+ * burst times, each stored as int64_t in the byte order of the machine that
+ * wrote it. Because the columns are plain arrays a loader can map the file
+ * and use them where they lie. Files of PROC_BIN_VERSION_INT32, whose
+ * columns are int32_t, are still read by copying the columns wider. */
+#define PROC_BIN_MAGIC "SCHEDBIN"
+#define PROC_BIN_VERSION 2
+#define PROC_BIN_VERSION_INT32 1
+/* Set in flags when every process arrives no earlier than the one before */
+#define PROC_BIN_SORTED 0x1
+
+
+/* The header of a binary workload file.
+ * magic - PROC_BIN_MAGIC, without its terminating null.
+ * version - PROC_BIN_VERSION, or PROC_BIN_VERSION_INT32 for an older file.
+ * flags - PROC_BIN_SORTED or 0.
+ * quantum - The round robin quantum.
+ * count - The number of processes. */
+struct procBinHeader
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t flags;
+	int32_t quantum;
+	uint32_t reserved;
+	uint64_t count;
+};
 
 
 /* A structure to hold information about a process. The data will
@@ -29,9 +72,9 @@
  * be the (line of the file that the data occurs on) - 1.*/
 struct proc
 {
-	int pNo;
-	int arrivalTime;
-	int burstTime;
+	int64_t pNo;
+	simTime arrivalTime;
+	simTime burstTime;
 };
 
 
@@ -57,6 +100,8 @@ struct proc
  *  	read the list of processes.
  *  LList outList - The list to place the processes in to. This list should be
  *  	initialised (with listCreate()) before calling procReadFile. Must be non-null.
+ *  	The processes are allocated with listAlloc, so they are all freed
+ *  	at once when the list is destroyed.
  *  int *outQuantum - A variable where the quantum read from the file will
  *  	be placed. Must be non-null.
  *
@@ -68,4 +113,97 @@ struct proc
 int procReadFile( const char *inFileName, LList outList, int *outQuantum );
 
 
+/****
+ *  procReadTable
+ *  Description: A fast version of procReadFile for large files. The file is
+ *  	mapped in to memory and scanned by hand straight in to the columns of
+ *  	a process table, which are allocated once up front. Nothing is
+ *  	allocated per process.
+ *  Binary workload files (see procWriteBinary) are recognised by their
+ *  	magic number and are not parsed at all. The table's columns point
+ *  	straight in to the mapped file, so loading costs no more than paging
+ *  	the file in.
+ *  The format is as for procReadFile, but read a line at a time: the first
+ *  	non-blank line holds just the quantum and every other non-blank line
+ *  	holds exactly one arrival time and one burst time.
+ *
+ *  const char *inFileName - The name of the file from which to
+ *  	read the list of processes.
+ *  ProcTable *outTable - Where to place the new table of processes. It should
+ *  	be freed with ptDestroy. Only set if no error occurred. Must be non-null.
+ *  size_t *outLine - Where to place the number of the offending line (counting
+ *  	from 1) when the format is wrong. May be null.
+ *
+ *  Returns an error code as for procReadFile.
+ */
+int procReadTable( const char *inFileName, ProcTable *outTable, size_t *outLine );
+
+
+/****
+ *  procReadTableParallel
+ *  Description: Does the same as procReadTable but parses a large text file
+ *  	on several threads at once. The file is split at newlines in to one
+ *  	piece per thread, and the pieces are joined back together in file
+ *  	order, so the table and any error line are exactly as procReadTable
+ *  	would give. Files of only a few megabytes are parsed on one thread.
+ *
+ *  const char *inFileName, ProcTable *outTable, size_t *outLine - As for
+ *  	procReadTable.
+ *  int numThreads - The most threads to parse with. Zero or less means one
+ *  	for every online processor.
+ *
+ *  Returns an error code as for procReadFile.
+ */
+int procReadTableParallel( const char *inFileName, int numThreads, ProcTable *outTable, size_t *outLine );
+
+
+/****
+ *  procScanLine
+ *  Description: Reads the integers on one line of a buffer. Integers may
+ *  	have a sign and are separated by spaces or tabs. Each must fit in a
+ *  	simTime.
+ *
+ *  const char **pos - The start of the line. Advanced to the start of the
+ *  	next line.
+ *  const char *end - The end of the buffer.
+ *  simTime *values - Where to place the integers. Must have room for
+ *  	PROC_MAX_FIELDS of them.
+ *
+ *  Returns the number of integers on the line, or -1 if the line holds
+ *  	anything else or more than PROC_MAX_FIELDS integers.
+ */
+int procScanLine( const char **pos, const char *end, simTime *values );
+
+
+/****
+ *  procWriteBinary
+ *  Description: Writes a table of processes to a file in the binary workload
+ *  	format. The file is flagged as sorted if the table is in order of
+ *  	arrival.
+ *
+ *  const char *outFileName - The name of the file to create or overwrite.
+ *  ProcTable table - The table to write. Must be non-null.
+ *
+ *  Returns PROC_NO_ERROR, or PROC_NO_OPEN if the file could not be created
+ *  	or written.
+ */
+int procWriteBinary( const char *outFileName, ProcTable table );
+
+
+/****
+ *  procWriteBinaryHeader
+ *  Description: Writes the header of a binary workload file, for a writer
+ *  	that produces the columns itself. The count arrival times and then the
+ *  	count burst times should follow, each as an int64_t.
+ *
+ *  FILE *outFile - The file to write to, at its start. Must be non-null.
+ *  int quantum - The round robin quantum.
+ *  uint64_t count - The number of processes that will follow.
+ *  int sorted - TRUE if they will be in order of arrival.
+ *
+ *  Returns TRUE if the header was written.
+ */
+int procWriteBinaryHeader( FILE *outFile, int quantum, uint64_t count, int sorted );
+
+
 #endif
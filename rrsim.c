@@ -1,4 +1,6 @@
 #include "rrsim.h"
+#include "RRQueue.h"
+#include "ProcSource.h"
 
 
 int rrCmp( const void *arg1, const void *arg2 )
@@ -12,93 +14,92 @@ int rrCmp( const void *arg1, const void *arg2 )
 }
 
 
-void rrSim( LList inProcList, int quantum, double *outAveWait, double *outAveTurn )
+/* The state of the round robin policy: its ready queue and quantum */
+struct rrState
 {
-	LList procList, rdyQueue;
-	struct rrData *runningProc;
-	Gantt gantt;
-	int timer;
+	RRQueue queue;
+	int quantum;
+};
 
-	assert( inProcList != NULL );
-	assert( quantum > 0 );
-	assert( outAveWait != NULL && outAveTurn != NULL );
 
-	/* Create the ready queue */
-	rdyQueue = listCreate();
+/* Makes an empty round robin ready queue */
+static void *rrCreate( size_t capacity, const struct simConfig *config )
+{
+	struct rrState *state;
 
-	/* Create a copy of inProcList so that we can sort it
-	 * by arrival time.*/
-	procList = listCopy( inProcList );		
-	listSort( procList, rrCmp );
+	assert( config->quantum > 0 );
 
-	/* Create our gantt chart. The start time will be the start time of the
-	 * first arrivaing process. Need to ensure that it will work if our
-	 * list size is 0 */
-	if( listSize( inProcList ) > 0 )
-	{
-		gantt = ganttCreate( ( (struct proc*)listGet( procList, 1 ) )->arrivalTime );
-	}
-	else
-	{
-		gantt = ganttCreate( 0 );
-	}
+	state = malloc( sizeof *state );
+	SIM_STAT( simAllocs++; )
+	state->queue = rrQueueCreate( capacity );
+	state->quantum = config->quantum;
+
+	return state;
+}
 
 
-	/* There is no currently running process and we are at time 0 */
-	runningProc = NULL;
-	timer = 0;
-	/* Terminate when both ready queue and list of processes is empty and when
-	 * there is no currently running process */
-	while( !( listSize( rdyQueue ) == 0 && listSize( procList ) == 0 && runningProc == NULL )  )
-	{
-		/* Add any arrived processes to the ready queue */
-		while( listSize( procList ) > 0 && ((struct proc*)listGet( procList, 1 ))->arrivalTime == timer )
-		{
-			struct rrData *procData;
-			procData = malloc( sizeof( *procData ) );
-			procData->proc = (struct proc*)listRemove( procList, 1 );
-			procData->runTime = 0;
-			procData->remaining = procData->proc->burstTime;
-			
-			/* Add process (with housekeeping data) to our ready queue */
-			listAdd( rdyQueue, procData, listSize( rdyQueue ) + 1 );
-		}
-
-		/* Check to see if a process is ready to run */
-		if( runningProc == NULL && listSize( rdyQueue ) > 0 )
-		{
-			/* Remove process from ready queue and begin
-			 * executing it */
-			runningProc = listRemove( rdyQueue, 1 );
-			runningProc->runTime = 0;
-		}
-
-		/* Check to see whether process should be
-		 * swapped out*/
-		if( runningProc != NULL )
-		{
-			runningProc->runTime++;
-			runningProc->remaining--;
-
-			/* Process's burst time is completed */
-			if( runningProc->remaining == 0 )
-			{
-				ganttAddBlock( gantt, runningProc->proc->pNo, runningProc->runTime );
-				/* Free our data here because it has been
-				 * removed from the ready queue already */
-				free( runningProc );
-				runningProc = NULL;
-			}
-			/* Process's quantum is up. Pre-empt. */
-			else if( runningProc->runTime >= quantum )
-			{
-				ganttAddBlock( gantt, runningProc->proc->pNo, runningProc->runTime );
-				listAdd( rdyQueue, runningProc, listSize( rdyQueue ) + 1 );
-				runningProc = NULL;
-			}
-		}
-		timer++;
-	}
+/* Frees a round robin ready queue */
+static void rrDestroy( void *arg )
+{
+	struct rrState *state = arg;
+
+	rrQueueDestroy( state->queue );
+	free( state );
+}
+
+
+/* Adds a process to the back of the queue */
+static void rrEnqueue( void *arg, const struct simJob *job )
+{
+	struct rrState *state = arg;
+
+	rrQueuePush( state->queue, job );
+}
+
+
+/* Takes the process at the front of the queue */
+static void rrPickNext( void *arg, struct simJob *outJob )
+{
+	struct rrState *state = arg;
+
+	rrQueuePop( state->queue, outJob );
+}
+
+
+/* Every process runs for at most one quantum at a time */
+static simTime rrQuantum( void *arg, const struct simJob *job )
+{
+	struct rrState *state = arg;
+
+	return state->quantum;
+}
+
+
+const struct simPolicy rrPolicy =
+{
+	rrCreate,
+	rrDestroy,
+	rrEnqueue,
+	rrPickNext,
+	rrQuantum,
+	NULL
+};
+
+
+void rrSim( LList inProcList, int quantum, double *outAveWait, double *outAveTurn )
+{
+	ProcSource src;
+	Gantt gantt;
+	struct simConfig config;
+	struct simResult result;
+
+	assert( inProcList != NULL );
+	assert( outAveWait != NULL && outAveTurn != NULL );
+
+	/* Sort a copy of inProcList by arrival time and simulate it */
+	simConfigDefaults( &config, quantum );
+	src = psFromList( inProcList, rrCmp );
+	simRun( src, &rrPolicy, &config, &gantt, &result );
 
 	/* Make sure list is non-empty to avoid divide by zero errors */
 	if( listSize( inProcList ) > 0 )
@@ -112,7 +113,49 @@ void rrSim( LList inProcList, int quantum, double *outAveWait, double *outAveTur
 	}
 
 	/* Clean up our used memory */
-	listDestroy( procList );
-	listDestroyFree( rdyQueue );
+	psDestroy( src );
 	ganttDestroy( gantt );
 }
+
+
+void rrSimMetrics( LList inProcList, int quantum, double *outAveWait, double *outAveTurn )
+{
+	ProcSource src;
+	struct simConfig config;
+
+	assert( inProcList != NULL );
+
+	simConfigDefaults( &config, quantum );
+	src = psFromList( inProcList, rrCmp );
+	simRunAverages( src, &rrPolicy, &config, outAveWait, outAveTurn );
+	psDestroy( src );
+}
+
+
+void rrSimTable( ProcTable table, int quantum, double *outAveWait, double *outAveTurn )
+{
+	ProcSource src;
+	struct simConfig config;
+
+	assert( table != NULL );
+
+	simConfigDefaults( &config, quantum );
+	src = psFromTable( table );
+	simRunAverages( src, &rrPolicy, &config, outAveWait, outAveTurn );
+	psDestroy( src );
+}
+
+
+void rrSimStream( ProcStream stream, int quantum, size_t progress, double *outAveWait, double *outAveTurn )
+{
+	ProcSource src;
+	struct simConfig config;
+
+	assert( stream != NULL );
+
+	simConfigDefaults( &config, quantum );
+	config.progress = progress;
+	src = psFromStream( stream );
+	simRunAverages( src, &rrPolicy, &config, outAveWait, outAveTurn );
+	psDestroy( src );
+}
@@ -11,24 +11,17 @@
 #include "Gantt.h"
 #include "LList.h"
 #include "proc.h"
+#include "ProcTable.h"
+#include "ProcStream.h"
 #include "common.h"
 #include "simcalc.h"
+#include "simengine.h"
 
 
-/* A small structure used to record round robin
- * housekeeeping data for a process.
- * struct proc *proc - A pointer to the process's information.
- * int runTime - The amount of time that the process has CONTINUOUSLY
- * 	been running for. This resets every time the quantum is reached.
- * int remaining - The remaining amount of time until all of the process's
- * 	burst time is exceeded.
- */
-struct rrData
-{
-	struct proc *proc;
-	int runTime;
-	int remaining;
-};
+/* The round robin policy for simRun. Its ready queue is an RRQueue, and
+ * each process runs for at most config->quantum before going to the back
+ * of it. */
+extern const struct simPolicy rrPolicy;
 
 
 /****
@@ -51,7 +44,10 @@ int rrCmp( const void *arg1, const void *arg2 );
 /****
  *  rrSim
  *  Description: A function to simulate a round robin scheduling algorithm on
- *  	a list of processes.
+ *  	a list of processes. The simulation is event driven: the clock jumps
+ *  	from one quantum expiry, completion or arrival to the next, so the
+ *  	running time depends on the number of scheduling decisions rather than
+ *  	on the length of the simulated time.
  *
  *  LList inProcList - The list of processes to simulate round robin for.
  *  	Must be non-null.
@@ -69,4 +65,55 @@ int rrCmp( const void *arg1, const void *arg2 );
  */
 void rrSim( LList inProcList, int quantum, double *outAveWait, double *outAveTurn );
 
+
+/****
+ *  rrSimMetrics
+ *  Description: Performs the same simulation as rrSim and produces the same
+ *  	averages, but never builds a gantt chart. Each process's waiting and
+ *  	turnaround times are accumulated as it completes, so the memory used
+ *  	is O(number of processes) no matter how many times they are
+ *  	pre-empted, and nothing is allocated per time slice.
+ *
+ *  The arguments and results are exactly as for rrSim.
+ */
+void rrSimMetrics( LList inProcList, int quantum, double *outAveWait, double *outAveTurn );
+
+
+/****
+ *  rrSimTable
+ *  Description: Performs the same simulation as rrSimMetrics on the
+ *  	processes in a process table. A table that is already in order of
+ *  	arrival is read in place without being copied or sorted.
+ *
+ *  ProcTable table - The table of processes to simulate. Must be non-null.
+ *  	It is not modified.
+ *  int quantum - As for rrSim. Usually ptQuantum( table ).
+ *  double *outAveWait, double *outAveTurn - As for rrSim.
+ *
+ *  Returns nothing. outAveWait and outAveTurn are set as for rrSim.
+ */
+void rrSimTable( ProcTable table, int quantum, double *outAveWait, double *outAveTurn );
+
+
+/****
+ *  rrSimStream
+ *  Description: Performs the same simulation as rrSimMetrics on a stream of
+ *  	processes that is already in order of arrival. Each process is read
+ *  	from the file only when the clock reaches its arrival time and is
+ *  	forgotten as soon as it completes, so only the processes in the ready
+ *  	queue are ever held in memory.
+ *
+ *  ProcStream stream - The stream of processes to simulate. Must be
+ *  	non-null. If it ends early because of an error the averages cover
+ *  	only the processes read before the error, and procStreamError should
+ *  	be checked once the simulation returns.
+ *  int quantum - As for rrSim. Usually procStreamQuantum( stream ).
+ *  size_t progress - How many processes complete between the running
+ *  	averages printed on stderr. Zero for none.
+ *  double *outAveWait, double *outAveTurn - As for rrSim.
+ *
+ *  Returns nothing. outAveWait and outAveTurn are set as for rrSim.
+ */
+void rrSimStream( ProcStream stream, int quantum, size_t progress, double *outAveWait, double *outAveTurn );
+
 #endif
@@ -1,131 +1,190 @@
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 #include <pthread.h>
+#include <semaphore.h>
+#include <sched.h>
 #include "../rrsim.h"
 #include "../sjfsim.h"
+#include "../BatchQueue.h"
+#include "../ResultRing.h"
+#include "../Workload.h"
 
 /* The maximum filename length */
 #define FILENAME_LEN 10
 
-#define NUMWORKERS 2
-#define NONE -1
-#define SJF 0
-#define RR 1
+/* The number of registered algorithms, each of which gets its own worker
+ * thread */
+#define NUMWORKERS ( (int)( sizeof algorithms / sizeof *algorithms ) )
 
+/* The longest file name that can be read from stdin in batch mode */
+#define BATCH_NAME_LEN 4096
+/* The number of jobs the batch queue holds for each worker */
+#define BATCH_JOBS_PER_WORKER 4
+/* The number of results each worker's ring can hold. A worker can not get
+ * more than one file ahead of main, so this never fills */
+#define RESULT_RING_SIZE 4
 
-/* A mutex used to control access to the fNameRead state variable and
+
+/* An algorithm that the simulator can run.
+ * name - The name used to tag its results.
+ * policy - The engine policy that simulates it. */
+struct simAlgorithm
+{
+	const char *name;
+	const struct simPolicy *policy;
+};
+
+
+/* The registered algorithms. Every workload is loaded once and then run
+ * under each of these, so adding an algorithm here costs no more I/O */
+static const struct simAlgorithm algorithms[] =
+{
+	{ "SJF", &sjfPolicy },
+	{ "RR", &rrPolicy }
+};
+
+/* TRUE if the counters from each simulation should be printed too */
+static int showStats = FALSE;
+
+/* The most threads each batch worker parses a file with. The workers may
+ * all be loading at once, so between them they should use each processor
+ * about once rather than each using every processor */
+static int batchLoadThreads = 1;
+
+
+/****
+ *  runAlgorithm
+ *  Description: Simulates one of the registered algorithms on a table with
+ *  	the table's own quantum. The table is only read, as it is shared with
+ *  	every other algorithm.
+ *
+ *  int algorithm - The algorithm's number in algorithms.
+ *  ProcTable table - The processes.
+ *  struct workerResult *outResult - Where to place the averages and the
+ *  	counters.
+ *
+ *  Returns nothing.
+ */
+static void runAlgorithm( int algorithm, ProcTable table, struct workerResult *outResult )
+{
+	ProcSource src;
+	struct simConfig config;
+	struct simResult result;
+
+	simConfigDefaults( &config, ptQuantum( table ) );
+	src = psFromTable( table );
+	simRun( src, algorithms[algorithm].policy, &config, NULL, &result );
+	calcAverages( result.waitTime, result.turnTime, result.count, &outResult->aveWait, &outResult->aveTurn );
+	outResult->stats = result.stats;
+	psDestroy( src );
+}
+
+
+/* A mutex used to control access to the jobRead state variable and
  * buffer1.
  * These variables should only be read/written when this mutex is held */
 static pthread_mutex_t readMut;
-/* Condition variables to signal when fNameRead[0] and fNameRead[1] are ready
- * to be read/written. */
-static pthread_cond_t sjfReadCond = PTHREAD_COND_INITIALIZER, rrReadCond = PTHREAD_COND_INITIALIZER;
-/* A state variable to signal when the workers have finished reading the filename
- * from buffer1. This is set to 1 when the filename HAS been read and set to 0
- * when the main thread writes a new filename and it HAS NOT yet been read. */
-static int fNameRead[NUMWORKERS] = { TRUE, TRUE };
-/* The buffer to hold the filename to be read by the worker threads. This is
- * named buffer1 as per the assignment specification. A more appropriate name
- * would be fNameBuffer or something of that sort.*/
-static char buffer1[FILENAME_LEN + 1];
-
-/* A mutex used to control access to the writer, buffer2 and fError 
- * variables. These variables should only be read/written when this mutex is
- * held. */
-static pthread_mutex_t writeMut;
-/* A condition variable to signal when the value of state variable writer has
- * changed and writing/reading is ready to be done on buffer2 */
-static pthread_cond_t bufWriteCond = PTHREAD_COND_INITIALIZER;
-/* A state variable to signal whose turn it is to write to buffer2. When
- * writer = NONE, any worker thread is allowed to write to buffer2. If writer
- * = SJF then the main thread must read buffer2 and set writer = NONE. If
- * writer = RR then the main thread must read buffer2 and set writer = NONE.*/
-static int writer = NONE;
-/* The buffer to hold the average waiting time and average turnaround time
- * for the simulations. writeMut must be held when this is written to. */
-static double buffer2[2];
-/* A state variable to signal when there has been an error reading the file.
- * This could be avoided by having the thread itself output an error message but
- * in this situation I felt it better to do it in the main thread. */
-static int fError;
+/* Condition variables to signal when a new workload has been written to
+ * buffer1 and when a worker has taken it */
+static pthread_cond_t jobCond = PTHREAD_COND_INITIALIZER, jobReadCond = PTHREAD_COND_INITIALIZER;
+/* A state variable to signal when the workers have finished reading the workload
+ * from buffer1. This is set to 1 when the workload HAS been read and set to 0
+ * when the main thread writes a new workload and it HAS NOT yet been read. */
+static int jobRead[NUMWORKERS];
+/* The buffer to hold the workload to be read by the worker threads. This is
+ * named buffer1 as per the assignment specification. Each worker is handed
+ * one reference to the workload. NULL tells the workers to quit. */
+static Workload buffer1;
+/* The number of each worker, passed to it when it is created */
+static int workerNums[NUMWORKERS];
+
+/* One result ring per worker. Each worker is the only producer for its
+ * ring and the main thread is the only consumer of all of them, so results
+ * are handed over without any locking. */
+static ResultRing results[NUMWORKERS];
+/* Posted once for every result pushed on to any ring, so the main thread
+ * can sleep until there is something to print. */
+static sem_t resultSem;
 
 
 
 /****
- *  sjfThread
- *  Description: A thread to simulate a shortest job first cpu scheduling
- *  algorithm on a list of processes. The name of the file containing the 
- *  processes should be written to global varable buffer1 and then read
- *  using mutal exclusion. The result will be written to buffer2 also 
- *  inside a critical section.
+ *  postResult
+ *  Description: Hands a worker's result to the main thread. The result is
+ *  	pushed on to the worker's own ring and main is woken through
+ *  	resultSem. The worker never waits for main to print it.
+ *
+ *  int worker - The worker's number in algorithms.
+ *  const struct workerResult *result - The result.
+ *
+ *  Returns nothing.
  */
-void *sjfThread( void *attr )
+static void postResult( int worker, const struct workerResult *result )
 {
-	/* local variable to copy the filename into */
-	char inFileName[FILENAME_LEN + 1];
+	/* The ring can only be full if main has fallen behind. Let it catch
+	 * up */
+	while( !resultRingPush( results[worker], result ) )
+	{
+		sched_yield();
+	}
+	sem_post( &resultSem );
+}
 
-	/* Loop until our fileName is QUIT */
+
+/****
+ *  algThread
+ *  Description: A thread to simulate one of the registered cpu scheduling
+ *  algorithms on each workload in turn. The workload is written to global
+ *  varable buffer1 by the main thread, already loaded, and then read
+ *  using mutal exclusion. The result is handed to the main thread
+ *  through the worker's result ring.
+ *
+ *  attr points to the worker's number in algorithms.
+ */
+void *algThread( void *attr )
+{
+	int worker = *(int *)attr;
+	/* local variable to copy the workload into */
+	Workload workload;
+
+	/* Loop until we are handed no workload */
 	do
 	{
-		/* Wait for a lock to read fNameRead */
+		/* Wait for a lock to read jobRead */
 		pthread_mutex_lock( &readMut );
 		/* Need to loop to prevent spurious wakeups */
-		while( fNameRead[SJF] != FALSE )
+		while( jobRead[worker] != FALSE )
 		{
-			/* Wait until sjfReadCond has been met */
-			pthread_cond_wait( &sjfReadCond, &readMut );
+			/* Wait until jobCond has been met */
+			pthread_cond_wait( &jobCond, &readMut );
 		}
-		strcpy( inFileName, buffer1 );
-		/* Filename has now been read */
-		fNameRead[SJF] = TRUE;
+		workload = buffer1;
+		/* Workload has now been read */
+		jobRead[worker] = TRUE;
 		/* Let the mutex go and tell the main thread that we have
 		 * finished reading */
 		pthread_mutex_unlock( &readMut );
-		pthread_cond_signal( &sjfReadCond );
+		pthread_cond_signal( &jobReadCond );
 
-		if( strcmp( "QUIT", inFileName ) != 0 )
+		if( workload != NULL )
 		{
-			LList procList;
-			int quantum;
-			int fileError;
-			double aveTurn, aveWait;
+			struct workerResult result;
 
-			/* Read processes from file */
-			procList = listCreate();
-			fileError = procReadFile( inFileName, procList, &quantum );
-
-			/* Compute sjf times before entering critical section */
-			if( fileError == PROC_NO_ERROR )
+			/* The table is only read, so every worker can use it
+			 * at once */
+			memset( &result, 0, sizeof result );
+			result.error = workload->error;
+			if( workload->error == PROC_NO_ERROR )
 			{
-				sjfSim( procList, &aveWait, &aveTurn );
+				runAlgorithm( worker, workload->table, &result );
 			}
 
-			/* Obtain a lock on writeMut so we can write result to
-			 * buffer2 */
-			pthread_mutex_lock( &writeMut );
-			while( writer != NONE )
-			{
-				/* Someone else has written. Wait for main to
-				 * read buffer2 before we can write */
-				pthread_cond_wait( &bufWriteCond, &writeMut );
-			}
-			/* Write results to buffer if no error */
-			if( fileError == PROC_NO_ERROR )
-			{
-				buffer2[0] = aveTurn;
-				buffer2[1] = aveWait;
-			}
-			writer = SJF;
-			fError = fileError;
-			/* Unlock writeMut and tell all threads waiting on
-			 * bufWriteCond to wake up */
-			pthread_mutex_unlock( &writeMut );
-			pthread_cond_broadcast( &bufWriteCond );
-
-			/* Free our memory */
-			listDestroyFree( procList );
+			postResult( worker, &result );
+			workloadRelease( workload );
 		}
-	} while( strcmp( "QUIT", inFileName ) != 0 );
+	} while( workload != NULL );
 
 	return NULL;
 }
@@ -133,192 +192,399 @@ void *sjfThread( void *attr )
 
 
 /****
- *  rrThread
- *  Description: A thread to simulate a round robin cpu scheduling
- *  algorithm on a list of processes. The name of the file containing the 
- *  processes should be written to global varable buffer1 and then read
- *  using mutal exclusion. The result will be written to buffer2 also 
- *  inside a critical section.
+ *  batchRun
+ *  Description: Runs one algorithm on a loaded workload and prints the
+ *  	result straight away, tagged with the file and the algorithm. The
+ *  	result is printed with a single call to printf so results from
+ *  	different workers never mix.
+ *
+ *  const struct batchJob *job - The job. Its reference to the workload is
+ *  	released.
+ *
+ *  Returns nothing.
  */
-void *rrThread( void *attr )
+static void batchRun( const struct batchJob *job )
 {
-	/* local variable to copy the filename into */
-	char inFileName[FILENAME_LEN + 1];
+	Workload workload = job->workload;
+	struct workerResult result;
 
-	/* Loop until our fileName is QUIT */
-	do
+	if( workload->error == PROC_NO_ERROR )
 	{
-		/* Wait for a lock to read fNameRead */
-		pthread_mutex_lock( &readMut );
-		/* Need to loop to prevent spurious wakeups */
-		while( fNameRead[RR] != FALSE )
+		char stats[SIM_STATS_LEN] = "";
+
+		runAlgorithm( job->algorithm, workload->table, &result );
+		if( showStats )
 		{
-			/* Wait until rrReadCond has been met */
-			pthread_cond_wait( &rrReadCond, &readMut );
+			simStatsFormat( &result.stats, stats );
 		}
-		strcpy( inFileName, buffer1 );
-		/* Filename has now been read */
-		fNameRead[RR] = TRUE;
-		/* Let the mutex go and tell the main thread that we have
-		 * finished reading */
-		pthread_mutex_unlock( &readMut );
-		pthread_cond_signal( &rrReadCond );
 
-		
-		if( strcmp( inFileName, "QUIT" ) != 0 )
+		printf( "%s: %s: Average Turnaround time = %f, Average Waiting Time = %f%s%s\n",
+			workload->fileName, algorithms[job->algorithm].name, result.aveTurn, result.aveWait,
+			showStats ? ", Counters: " : "", stats );
+	}
+	else
+	{
+		printf( "%s: %s: Error occurred reading file!\n", workload->fileName, algorithms[job->algorithm].name );
+	}
+
+	workloadRelease( workload );
+}
+
+
+/****
+ *  batchWorker
+ *  Description: A worker thread for batch mode. Takes jobs from the queue
+ *  	passed in attr until it is closed and empty. The first job for a file
+ *  	has no workload yet. The worker that takes it loads the file, so files
+ *  	are parsed on every worker at once, and queues a job for each of the
+ *  	other algorithms on the one loaded workload. Any it can not queue
+ *  	because the queue is full it runs itself.
+ */
+void *batchWorker( void *attr )
+{
+	BatchQueue jobs = attr;
+	struct batchJob job;
+
+	while( batchQueuePop( jobs, &job ) )
+	{
+		if( job.workload == NULL )
 		{
-			LList procList;
-			int quantum;
-			int fileError;
-			double aveWait, aveTurn;
+			struct batchJob other;
+			int left[NUMWORKERS];
+			int numLeft = 0;
+			int i;
 
-			/* Read processes from file */
-			procList = listCreate();
-			fileError = procReadFile( inFileName, procList, &quantum );
+			job.workload = workloadLoad( job.fileName, batchLoadThreads, NUMWORKERS );
+			free( job.fileName );
+			job.fileName = NULL;
 
-			/* Compute rr times before entering critical section */
-			if( fileError == PROC_NO_ERROR )
+			other = job;
+			for( other.algorithm = 0; other.algorithm < NUMWORKERS; other.algorithm++ )
 			{
-				rrSim( procList, quantum, &aveWait, &aveTurn );
+				if( other.algorithm != job.algorithm && !batchQueueTryPush( jobs, &other ) )
+				{
+					left[numLeft++] = other.algorithm;
+				}
 			}
+			batchQueueLoaded( jobs );
 
-			/* Obtain a lock on writeMut so we can write result to
-			 * buffer2 */
-			pthread_mutex_lock( &writeMut );
-			while( writer != NONE )
+			batchRun( &job );
+			for( i = 0; i < numLeft; i++ )
 			{
-				/* Someone else has written. Wait for main to
-				 * read buffer2 before we can write */
-				pthread_cond_wait( &bufWriteCond, &writeMut );
+				other.algorithm = left[i];
+				batchRun( &other );
 			}
-			/* Write results to buffer if no error */
-			if( fileError == PROC_NO_ERROR ) 	
+		}
+		else
+		{
+			batchRun( &job );
+		}
+	}
+
+	return NULL;
+}
+
+
+/****
+ *  batchFeed
+ *  Description: Queues the job that loads a file, waiting for room in the
+ *  	queue if it is full. Whichever worker takes it loads the file once and
+ *  	shares it with the jobs for the other algorithms.
+ *
+ *  BatchQueue jobs - The job queue.
+ *  const char *fileName - The file.
+ *
+ *  Returns nothing.
+ */
+static void batchFeed( BatchQueue jobs, const char *fileName )
+{
+	struct batchJob job;
+
+	job.workload = NULL;
+	job.fileName = malloc( strlen( fileName ) + 1 );
+	strcpy( job.fileName, fileName );
+	job.algorithm = 0;
+	batchQueuePush( jobs, &job );
+}
+
+
+/****
+ *  batchFeedStdin
+ *  Description: Queues jobs for every file named on stdin, one per line.
+ *  	Blank lines are skipped.
+ *
+ *  BatchQueue jobs - The job queue.
+ *
+ *  Returns nothing.
+ */
+static void batchFeedStdin( BatchQueue jobs )
+{
+	char fileName[BATCH_NAME_LEN + 2];
+
+	while( fgets( fileName, sizeof fileName, stdin ) != NULL )
+	{
+		fileName[strcspn( fileName, "\r\n" )] = '\0';
+		if( fileName[0] != '\0' )
+		{
+			batchFeed( jobs, fileName );
+		}
+	}
+}
+
+
+/****
+ *  batchMain
+ *  Description: Runs batch mode. The main thread queues each file on a
+ *  	bounded queue and a pool of worker threads loads the files and runs
+ *  	(workload, algorithm) jobs from it, so every file can be loading and
+ *  	every file and algorithm running at once, and a slow file holds up
+ *  	only the worker running it.
+ *
+ *  int numWorkers - The number of worker threads to start. Must be positive.
+ *  int numFiles - The number of entries in files.
+ *  char *files[] - The files to simulate. "-" means read file names from
+ *  	stdin, one per line.
+ *
+ *  Returns 0 on success or 1 if the workers could not be started.
+ */
+static int batchMain( int numWorkers, int numFiles, char *files[] )
+{
+	BatchQueue jobs;
+	pthread_t *workers;
+	int numStarted = 0;
+	int i;
+	int success = 0;
+
+	assert( numWorkers > 0 );
+
+	/* Share the processors out between the workers' parsers */
+	batchLoadThreads = sysconf( _SC_NPROCESSORS_ONLN ) / numWorkers;
+	if( batchLoadThreads < 1 )
+	{
+		batchLoadThreads = 1;
+	}
+
+	jobs = batchQueueCreate( numWorkers * BATCH_JOBS_PER_WORKER );
+	if( jobs == NULL )
+	{
+		printf( "Could not create job queue!\nExiting!\n" );
+		success = 1;
+	}
+	else
+	{
+		workers = malloc( numWorkers * sizeof *workers );
+		while( numStarted < numWorkers && pthread_create( &workers[numStarted], NULL, batchWorker, jobs ) == 0 )
+		{
+			numStarted++;
+		}
+
+		if( numStarted == 0 )
+		{
+			printf( "Could not create worker threads!\nExiting!\n" );
+			success = 1;
+		}
+		else
+		{
+			/* The main thread is the feeder. It only reads names, so it
+			 * never holds up the workers */
+			for( i = 0; i < numFiles; i++ )
 			{
-				buffer2[0] = aveTurn;
-				buffer2[1] = aveWait;
+				if( strcmp( files[i], "-" ) == 0 )
+				{
+					batchFeedStdin( jobs );
+				}
+				else
+				{
+					batchFeed( jobs, files[i] );
+				}
 			}
-			writer = RR;
-			fError = fileError;
-			/* Unlock writeMut and tell all threads waiting on
-			 * bufWriteCond to wake up */
-			pthread_mutex_unlock( &writeMut );
-			pthread_cond_broadcast( &bufWriteCond );
-
-			/* Free our memory */
-			listDestroyFree( procList );
 		}
-	} while( strcmp( "QUIT", inFileName ) != 0 );
 
-	return NULL;
+		/* Let the workers finish what is queued and wait for them */
+		batchQueueClose( jobs );
+		for( i = 0; i < numStarted; i++ )
+		{
+			pthread_join( workers[i], NULL );
+		}
+		free( workers );
+		batchQueueDestroy( jobs );
+	}
+
+	return success;
 }
 
-int main( void )
+
+int main( int argc, char *argv[] )
 {
-	pthread_t sjf, rr;
+	pthread_t workers[NUMWORKERS];
+	int numStarted = 0;
+	int numWorkers = 0;
+	int badOption = FALSE;
+	int opt;
+	int i;
 	int success;
 
+	/* -j sets the number of workers for batch mode. -c prints what each
+	 * simulation did */
+	while( ( opt = getopt( argc, argv, "j:c" ) ) != -1 )
+	{
+		if( opt == 'j' )
+		{
+			numWorkers = atoi( optarg );
+		}
+		else if( opt == 'c' )
+		{
+			showStats = TRUE;
+		}
+		else
+		{
+			badOption = TRUE;
+		}
+	}
+	if( numWorkers <= 0 )
+	{
+		numWorkers = sysconf( _SC_NPROCESSORS_ONLN );
+	}
+
+	if( badOption )
+	{
+		fprintf( stderr, "Usage: %s [-c] [-j workers] [file | -]...\n", argv[0] );
+		success = 1;
+	}
+	/* Any files given mean batch mode. Otherwise ask for files one at a
+	 * time as before */
+	else if( optind < argc )
+	{
+		success = batchMain( numWorkers, argc - optind, argv + optind );
+	}
 	/* Attempt to initialise our mutexes */
-	if( pthread_mutex_init( &readMut, NULL ) > 0 || pthread_mutex_init( &writeMut, NULL ) > 0 )
+	else if( pthread_mutex_init( &readMut, NULL ) > 0 || sem_init( &resultSem, 0, 0 ) != 0 )
 	{
 		printf( "Could not create reading mutex!\nExiting!\n" );
 		success = 1;
 	}
 	else
 	{
-		/* Mutex initialisation successful. Initialise threads */
-		if( pthread_create( &sjf, NULL, sjfThread, NULL ) != 0 )
+		/* Mutex initialisation successful. Initialise rings and threads.
+		 * No worker has a workload to read yet */
+		for( i = 0; i < NUMWORKERS; i++ )
 		{
-			printf( "Could not create shortest job first thread!\nExiting!\n" );
-			success = 1;
+			results[i] = resultRingCreate( RESULT_RING_SIZE );
+			jobRead[i] = TRUE;
+			workerNums[i] = i;
+		}
+		while( numStarted < NUMWORKERS && pthread_create( &workers[numStarted], NULL, algThread, &workerNums[numStarted] ) == 0 )
+		{
+			numStarted++;
 		}
-		else if( pthread_create( &rr, NULL, rrThread, NULL ) != 0 )
+
+		if( numStarted < NUMWORKERS )
 		{
-			printf( "Could not create round robin thread!\nExiting\n" );
+			printf( "Could not create %s thread!\nExiting!\n", algorithms[numStarted].name );
 			success = 1;
-			/* Only used here for error handling. Elsewhere thread is
+			/* Only used here for error handling. Elsewhere threads are
 			 * terminated properly */
-			pthread_cancel( sjf );
+			for( i = 0; i < numStarted; i++ )
+			{
+				pthread_cancel( workers[i] );
+			}
 		}
 		else
 		{
+			char fileName[FILENAME_LEN + 1];
+			Workload workload;
+
 			/* All threads and mutexes created */
 			do
 			{
+				/* Read filename and load the workload outside of the
+				 * critical section. Every result for the last one has
+				 * been printed before the prompt, so the workers are
+				 * idle and the load can use every processor */
+				printf( "Scheduling simulation:" );
+				scanf( "%s", fileName );
+				workload = NULL;
+				if( strcmp( "QUIT", fileName ) != 0 )
+				{
+					workload = workloadLoad( fileName, 0, NUMWORKERS );
+				}
+
 				/* Try to obtain lock on readMut so we can write buffer1*/
 				pthread_mutex_lock( &readMut );
-				while( fNameRead[SJF] == FALSE || fNameRead[RR] == FALSE )
+				for( i = 0; i < NUMWORKERS; i++ )
 				{
-					/* Wait on both conditions to make sure that both
-					 * threads have read the filename */
-					if( fNameRead[SJF] == FALSE )
-					{
-						pthread_cond_wait( &sjfReadCond, &readMut );
-					}
-					if( fNameRead[RR] == FALSE )
+					/* Wait on the condition to make sure that every
+					 * thread has read the last workload */
+					while( jobRead[i] == FALSE )
 					{
-						pthread_cond_wait( &rrReadCond, &readMut );
+						pthread_cond_wait( &jobReadCond, &readMut );
 					}
 				}
-				/* Read filename into buffer variable. Ideally the I/O wouldn't be in the
-				 * critical section here but it doesn't matter because our threads can only
-				 * be sleeping here anyway */
-				printf( "Scheduling simulation:" );
-				scanf( "%s", buffer1 );
-				/* Set state variables to un-read. Release lock and signal both conditions */
-				fNameRead[SJF] = fNameRead[RR] = FALSE;
+				/* Set state variables to un-read. Release lock and wake every worker */
+				buffer1 = workload;
+				for( i = 0; i < NUMWORKERS; i++ )
+				{
+					jobRead[i] = FALSE;
+				}
 				pthread_mutex_unlock( &readMut );
-				pthread_cond_signal( &sjfReadCond );
-				pthread_cond_signal( &rrReadCond );
+				pthread_cond_broadcast( &jobCond );
 
-				if( strcmp( "QUIT", buffer1 ) != 0 )
+				if( workload != NULL )
 				{
 					int answersRcvd;
-					/* Make sure that we read the answers from BOTH threads */
-					for( answersRcvd = 0; answersRcvd < 2; answersRcvd++ )
+					/* Make sure that we read the answers from ALL threads */
+					for( answersRcvd = 0; answersRcvd < NUMWORKERS; answersRcvd++ )
 					{
-						/* Obtain a lock on writeMut */
-						pthread_mutex_lock( &writeMut );
-						while( writer == NONE )
-						{
-							pthread_cond_wait( &bufWriteCond, &writeMut );
-						}
-						
-						/* Print the writer so that we know which result is which */
-						if( writer == SJF )
+						struct workerResult result;
+						int worker = 0;
+
+						/* Sleep until a result has been posted, then
+						 * find the ring it is in */
+						while( sem_wait( &resultSem ) != 0 )
 						{
-							printf( "SJF: " );
 						}
-						else if( writer == RR )
+						while( !resultRingPop( results[worker], &result ) )
 						{
-							printf( "RR: " );
+							worker = ( worker + 1 ) % NUMWORKERS;
 						}
-						
-						if( fError != PROC_NO_ERROR )
+
+						/* Print the worker so that we know which result is which */
+						printf( "%s: ", algorithms[worker].name );
+
+						if( result.error != PROC_NO_ERROR )
 						{
 							printf( "Error occurred reading file!\n" );
 						}
 						else
 						{
-							printf("Average Turnaround time = %f, Average Waiting Time = %f\n", buffer2[0], buffer2[1] );
+							printf("Average Turnaround time = %f, Average Waiting Time = %f\n", result.aveTurn, result.aveWait );
+							if( showStats )
+							{
+								char stats[SIM_STATS_LEN];
+
+								simStatsFormat( &result.stats, stats );
+								printf( "%s: Counters: %s\n", algorithms[worker].name, stats );
+							}
 						}
-						/* Unlock the mutex and signal bufWriteCond to wake up a thread */
-						writer = NONE;
-						pthread_mutex_unlock( &writeMut );
-						pthread_cond_signal( &bufWriteCond );
 					}
 				}
-			} while( strcmp( "QUIT", buffer1 ) != 0 );
+			} while( workload != NULL );
 
 			/* Wait for threads to complete */
-			pthread_join( sjf, NULL );
-			pthread_join( rr, NULL );
+			for( i = 0; i < NUMWORKERS; i++ )
+			{
+				pthread_join( workers[i], NULL );
+			}
 			success = 0;
 		}
-		/* Clean up our mutexes */
+		/* Clean up our mutexes and rings */
 		pthread_mutex_destroy( &readMut );
-		pthread_mutex_destroy( &writeMut );
+		sem_destroy( &resultSem );
+		for( i = 0; i < NUMWORKERS; i++ )
+		{
+			resultRingDestroy( results[i] );
+		}
 	}
 
 	return success;
 }
-
@@ -1,30 +1,58 @@
 #include "simcalc.h"
 
 
-int cmp( int arg1, int arg2 )
+/* Integers smaller in size than this convert to a double exactly */
+#define CALC_EXACT_DOUBLE ( (simTime)1 << 53 )
+
+
+int cmp( simTime arg1, simTime arg2 )
 {
 	int result;
 
+	/* Compared directly, as the difference of two times far apart can
+	 * overflow */
 	if( arg1 == arg2 )
 	{
 		result = 0;
 	}
+	else if( arg1 < arg2 )
+	{
+		result = -1;
+	}
 	else
 	{
-		/* Dividing the difference between the absolute
-		 * value of the difference will give us 1 with either
-		 * + or - sign.*/
-		result = ( arg1 - arg2 ) / abs( arg1 - arg2 );	
+		result = 1;
 	}
 
 	return result;
 }
 
 
+double calcMean( simTime total, size_t count )
+{
+	double mean;
+
+	assert( count > 0 );
+
+	/* A total this small is exact as a double. A larger one would be
+	 * rounded, so its whole part is divided out in integers first */
+	if( total > -CALC_EXACT_DOUBLE && total < CALC_EXACT_DOUBLE )
+	{
+		mean = total / (double)count;
+	}
+	else
+	{
+		mean = (double)( total / (simTime)count ) + (double)( total % (simTime)count ) / count;
+	}
+
+	return mean;
+}
+
+
 double calcAveWait( Gantt gantt, LList inProcList )
 {
 	int procIdx;
-	int waitTime = 0;
+	simTime waitTime = 0;
 
 	assert( gantt != NULL );
 	assert( inProcList != NULL && listSize( inProcList ) > 0 );
@@ -35,7 +63,7 @@ double calcAveWait( Gantt gantt, LList inProcList )
 	{
 		struct proc *curProc;
 		int numBlocks, blockIdx;
-		int procWaitTime, lastTime;
+		simTime procWaitTime, lastTime;
 
 		curProc = listGet( inProcList, procIdx );
 		/* The last time that the process was running.*/
@@ -56,14 +84,14 @@ double calcAveWait( Gantt gantt, LList inProcList )
 		waitTime += procWaitTime;
 	}
 
-	return waitTime / (double)listSize( inProcList );
+	return calcMean( waitTime, listSize( inProcList ) );
 }
 
 
 double calcAveTurn( Gantt gantt, LList inProcList )
 {
 	int procIdx;
-	int turnTime = 0;
+	simTime turnTime = 0;
 
 	assert( gantt != NULL );
 	assert( inProcList != NULL && listSize( inProcList ) > 0 );
@@ -87,5 +115,22 @@ double calcAveTurn( Gantt gantt, LList inProcList )
 		turnTime += gBlock->endTime - curProc->arrivalTime;
 	}
 
-	return turnTime / (double)listSize( inProcList );
+	return calcMean( turnTime, listSize( inProcList ) );
+}
+
+
+void calcAverages( simTime waitTime, simTime turnTime, size_t numProcs, double *outAveWait, double *outAveTurn )
+{
+	assert( outAveWait != NULL && outAveTurn != NULL );
+
+	/* Avoid dividing by zero when there were no processes */
+	if( numProcs > 0 )
+	{
+		*outAveWait = calcMean( waitTime, numProcs );
+		*outAveTurn = calcMean( turnTime, numProcs );
+	}
+	else
+	{
+		*outAveWait = *outAveTurn = 0.0;
+	}
 }
@@ -24,12 +24,27 @@
  *  arg1 < arg2, 0 if arg1 == arg2 and 1 if arg1 > arg2. This is used
  *  by functions that are supplied as callbacks to listSort.
  *
- *  int arg1 - First integer
- *  int arg2 - Second integer
+ *  simTime arg1 - First integer
+ *  simTime arg2 - Second integer
  *
  *  Returns -1 if arg1 < arg2, 0 if arg1 == arg2, 1 if arg1 > arg2.
  */
-int cmp( int arg1, int arg2 );
+int cmp( simTime arg1, simTime arg2 );
+
+
+/****
+ *  calcMean
+ *  Description: Divides an exact total by a count. A total too large for
+ *  	a double to hold exactly has the whole part of its mean found in
+ *  	integers, so only the remainder is rounded and the mean is as exact
+ *  	as a double can hold however large the total is.
+ *
+ *  simTime total - The total.
+ *  size_t count - The number of things totalled. Must be positive.
+ *
+ *  Returns the mean.
+ */
+double calcMean( simTime total, size_t count );
 
 
 /****
@@ -64,4 +79,22 @@ double calcAveWait( Gantt gantt, LList inProcList );
 double calcAveTurn( Gantt gantt, LList inProcList );
 
 
+/****
+ *  calcAverages
+ *  Description: Turns the total waiting and turnaround times accumulated
+ *  	during a simulation in to averages, with calcMean.
+ *
+ *  simTime waitTime - The total waiting time of all processes.
+ *  simTime turnTime - The total turnaround time of all processes.
+ *  size_t numProcs - The number of processes.
+ *  double *outAveWait - Where to place the average waiting time. Will be
+ *  	zero if there were no processes. Must be non-null.
+ *  double *outAveTurn - Where to place the average turnaround time. Will be
+ *  	zero if there were no processes. Must be non-null.
+ *
+ *  Returns nothing.
+ */
+void calcAverages( simTime waitTime, simTime turnTime, size_t numProcs, double *outAveWait, double *outAveTurn );
+
+
 #endif
@@ -0,0 +1,1186 @@
+#include <stdio.h>
+#include <string.h>
+#include "simengine.h"
+
+
+/* The counters of a simulation as it runs, with what is needed to finish
+ * them off at the end. Only touched through SIM_STAT.
+ * stats - The counters so far.
+ * busy - The total time spent running processes, on every CPU.
+ * queueSum - The sum of the ready queue depths seen at each event.
+ * numSamples - The number of depths in queueSum.
+ * allocsBefore - simAllocs when the simulation started. */
+struct simCounter
+{
+	struct simStats stats;
+	simTime busy;
+	double queueSum;
+	long numSamples;
+	long allocsBefore;
+};
+
+
+/****
+ *  simCountStart
+ *  Description: Zeroes the counters at the start of a simulation.
+ *
+ *  struct simCounter *counter - The counters.
+ *
+ *  Returns nothing.
+ */
+static void simCountStart( struct simCounter *counter )
+{
+	memset( counter, 0, sizeof *counter );
+	SIM_STAT( counter->allocsBefore = simAllocs; )
+}
+
+
+#ifdef SIM_STATS
+/* Counts the depth of the ready queues at one event */
+static void simCountQueue( struct simCounter *counter, size_t depth )
+{
+	counter->queueSum += depth;
+	counter->numSamples++;
+	if( depth > counter->stats.maxQueue )
+	{
+		counter->stats.maxQueue = depth;
+	}
+}
+#endif
+
+
+/****
+ *  simCountFinish
+ *  Description: Works out the counters that are only known at the end and
+ *  	copies them all in to the result.
+ *
+ *  struct simCounter *counter - The counters.
+ *  int numCpus - The number of CPUs simulated.
+ *  struct simResult *outResult - The result, with count, start, end and
+ *  	overhead already set.
+ *
+ *  Returns nothing.
+ */
+static void simCountFinish( struct simCounter *counter, int numCpus, struct simResult *outResult )
+{
+	SIM_STAT(
+		if( outResult->count > 0 )
+		{
+			counter->stats.idleTime = numCpus * ( outResult->end - outResult->start ) - counter->busy - outResult->overhead;
+		}
+		if( counter->numSamples > 0 )
+		{
+			counter->stats.meanQueue = counter->queueSum / counter->numSamples;
+		}
+		counter->stats.allocations = simAllocs - counter->allocsBefore;
+	)
+	outResult->stats = counter->stats;
+}
+
+
+/****
+ *  simTake
+ *  Description: Takes the next process from the source as a new job.
+ *
+ *  ProcSource src - The source. Must not be empty.
+ *  struct simJob *outJob - Where to place the job.
+ *
+ *  Returns nothing.
+ */
+static void simTake( ProcSource src, struct simJob *outJob )
+{
+	psPop( src, &outJob->proc );
+	outJob->runTime = 0;
+	outJob->remaining = outJob->proc.burstTime;
+	outJob->firstRun = -1;
+	outJob->preemptions = 0;
+	outJob->stopped = -1;
+	outJob->lastCpu = -1;
+}
+
+
+/****
+ *  simOverhead
+ *  Description: Works out how long a CPU spends switching to a process
+ *  	before it can run: the dispatch latency if it ran a different process
+ *  	last, plus the time to refill however much of the process's cache has
+ *  	gone cold since it last ran there.
+ *
+ *  const struct simConfig *config - The costs.
+ *  const struct simJob *job - The process about to run.
+ *  int cpu - The CPU it is about to run on.
+ *  int64_t lastPNo - The process the CPU ran last, or -1 if none.
+ *  simTime now - The current time.
+ *
+ *  Returns the overhead.
+ */
+static simTime simOverhead( const struct simConfig *config, const struct simJob *job, int cpu, int64_t lastPNo, simTime now )
+{
+	simTime overhead = 0;
+
+	if( job->proc.pNo != lastPNo )
+	{
+		overhead += config->dispatch;
+	}
+
+	/* Warmth is lost in proportion to time away until nothing is left */
+	if( job->stopped < 0 || job->lastCpu != cpu || now - job->stopped >= config->cold )
+	{
+		overhead += config->refill;
+	}
+	else
+	{
+		overhead += config->refill * ( now - job->stopped ) / config->cold;
+	}
+
+	return overhead;
+}
+
+
+/****
+ *  simExport
+ *  Description: Writes the result of a process that has just completed to
+ *  	an export.
+ *
+ *  Export export - The export.
+ *  const struct simJob *job - The process.
+ *  simTime completion - When it completed.
+ *
+ *  Returns nothing.
+ */
+static void simExport( Export export, const struct simJob *job, simTime completion )
+{
+	struct procResult result;
+
+	result.pNo = job->proc.pNo;
+	result.arrivalTime = job->proc.arrivalTime;
+	result.burstTime = job->proc.burstTime;
+	result.firstRun = job->firstRun;
+	result.response = job->firstRun - job->proc.arrivalTime;
+	result.completion = completion;
+	result.turnTime = completion - job->proc.arrivalTime;
+	result.waitTime = result.turnTime - job->proc.burstTime;
+	result.preemptions = job->preemptions;
+	exportAdd( export, &result );
+}
+
+
+/****
+ *  simProgress
+ *  Description: Counts a process that has just completed, and prints the
+ *  	running averages on stderr if enough have completed since they were
+ *  	last printed.
+ *
+ *  const struct simConfig *config - The settings of the simulation.
+ *  size_t *done - The number of processes completed so far, which is
+ *  	incremented.
+ *  simTime waitTime - The total waiting time of those processes.
+ *  simTime turnTime - Their total turnaround time.
+ *
+ *  Returns nothing.
+ */
+static void simProgress( const struct simConfig *config, size_t *done, simTime waitTime, simTime turnTime )
+{
+	double aveWait, aveTurn;
+
+	( *done )++;
+	if( config->progress > 0 && *done % config->progress == 0 )
+	{
+		calcAverages( waitTime, turnTime, *done, &aveWait, &aveTurn );
+		fprintf( stderr, "%lu processes: Average Waiting Time: %f, Average Turnaround Time: %f\n",
+			(unsigned long)*done, aveWait, aveTurn );
+	}
+}
+
+
+void simConfigDefaults( struct simConfig *outConfig, int quantum )
+{
+	assert( outConfig != NULL );
+
+	outConfig->quantum = quantum;
+	outConfig->numCpus = 1;
+	outConfig->placement = SIM_PLACE_GLOBAL;
+	outConfig->export = NULL;
+	outConfig->dispatch = 0;
+	outConfig->refill = 0;
+	outConfig->cold = SIM_DEFAULT_COLD;
+	outConfig->progress = 0;
+}
+
+
+/****
+ *  simAdmit
+ *  Description: Moves every process that arrives strictly before the given
+ *  	time from the process source to the ready queue, in order of arrival.
+ *
+ *  ProcSource src - The remaining processes, in order of arrival.
+ *  const struct simPolicy *policy, void *state - The policy and its queue.
+ *  simTime before - Processes with an arrival time less than this are
+ *  	admitted.
+ *
+ *  Returns the number of processes admitted.
+ */
+static size_t simAdmit( ProcSource src, const struct simPolicy *policy, void *state, simTime before )
+{
+	size_t numAdmitted = 0;
+
+	while( psPeek( src ) != NULL && psPeek( src )->arrivalTime < before )
+	{
+		struct simJob job;
+
+		simTake( src, &job );
+		policy->enqueue( state, &job );
+		numAdmitted++;
+	}
+
+	return numAdmitted;
+}
+
+
+void simRun( ProcSource src, const struct simPolicy *policy, const struct simConfig *config, Gantt *outGantt, struct simResult *outResult )
+{
+	void *state;
+	size_t numReady = 0, numAdmitted, done = 0;
+	struct simJob runningJob;
+	Gantt gantt = NULL;
+	simTime timer;
+	int64_t lastPNo = -1;
+	simTime waitTime = 0, turnTime = 0, overheadTime = 0;
+	struct simCounter counter;
+
+	assert( src != NULL );
+	assert( policy != NULL && config != NULL );
+	assert( config->dispatch >= 0 && config->refill >= 0 && config->cold > 0 );
+	assert( outResult != NULL );
+
+	simCountStart( &counter );
+	outResult->start = ( psPeek( src ) != NULL ) ? psPeek( src )->arrivalTime : 0;
+
+	/* Create the ready queue. It can never hold more than every process
+	 * at once so sizing it for that means it never has to grow. A stream
+	 * only knows about the processes read so far, so its queue starts
+	 * small and grows with the number of processes in flight */
+	state = policy->create( psSize( src ), config );
+
+	/* Create our gantt chart. The start time will be the start time of the
+	 * first arrivaing process. Need to ensure that it will work if there
+	 * are no processes */
+	if( outGantt != NULL )
+	{
+		if( psPeek( src ) != NULL )
+		{
+			gantt = ganttCreate( psPeek( src )->arrivalTime );
+		}
+		else
+		{
+			gantt = ganttCreate( 0 );
+		}
+	}
+
+	timer = 0;
+	/* Terminate when both the ready queue and source are empty */
+	while( !( numReady == 0 && psPeek( src ) == NULL ) )
+	{
+		simTime slice, end, overhead;
+
+		/* Nothing is ready so the CPU sits idle until the next arrival. The
+		 * idle time is recorded so later blocks keep their true start times */
+		if( numReady == 0 )
+		{
+			simTime nextArrival;
+
+			nextArrival = psPeek( src )->arrivalTime;
+			if( nextArrival > timer )
+			{
+				if( gantt != NULL && ganttNumBlocks( gantt ) > 0 )
+				{
+					ganttAddBlock( gantt, GANTT_IDLE, nextArrival - timer );
+					SIM_STAT( counter.stats.ganttBlocks++; )
+				}
+				timer = nextArrival;
+			}
+		}
+
+		/* Add any processes that have arrived by now to the ready queue */
+		numAdmitted = simAdmit( src, policy, state, timer + 1 );
+		numReady += numAdmitted;
+		SIM_STAT( counter.stats.events += numAdmitted; )
+		SIM_STAT( counter.stats.queueOps += numAdmitted; )
+		SIM_STAT( simCountQueue( &counter, numReady ); )
+
+		/* Let the policy pick a process and say how long it may run */
+		policy->pickNext( state, &runningJob );
+		numReady--;
+		SIM_STAT( counter.stats.queueOps++; )
+		SIM_STAT(
+			if( runningJob.proc.pNo != lastPNo )
+			{
+				counter.stats.switches++;
+			}
+		)
+
+		/* The CPU switches to it before it runs */
+		overhead = simOverhead( config, &runningJob, 0, lastPNo, timer );
+		lastPNo = runningJob.proc.pNo;
+		if( overhead > 0 )
+		{
+			if( gantt != NULL )
+			{
+				ganttAddBlock( gantt, GANTT_OVERHEAD, overhead );
+				SIM_STAT( counter.stats.ganttBlocks++; )
+			}
+			timer += overhead;
+			overheadTime += overhead;
+		}
+		if( runningJob.firstRun < 0 )
+		{
+			runningJob.firstRun = timer;
+		}
+
+		slice = policy->quantum( state, &runningJob );
+		if( slice > runningJob.remaining )
+		{
+			slice = runningJob.remaining;
+		}
+		end = timer + slice;
+
+		/* Processes that arrive while it runs join the queue before it
+		 * does. A policy that pre-empts may stop it at one of them */
+		if( policy->preempt == NULL )
+		{
+			numAdmitted = simAdmit( src, policy, state, end );
+			numReady += numAdmitted;
+			SIM_STAT( counter.stats.events += numAdmitted; )
+			SIM_STAT( counter.stats.queueOps += numAdmitted; )
+		}
+		else
+		{
+			while( psPeek( src ) != NULL && psPeek( src )->arrivalTime < end )
+			{
+				struct simJob arrived, running;
+				simTime at;
+
+				simTake( src, &arrived );
+				policy->enqueue( state, &arrived );
+				numReady++;
+				SIM_STAT( counter.stats.events++; )
+				SIM_STAT( counter.stats.queueOps++; )
+
+				/* One that arrived during the switch is dealt with as
+				 * the process starts running */
+				at = ( arrived.proc.arrivalTime > timer ) ? arrived.proc.arrivalTime : timer;
+				running = runningJob;
+				running.remaining -= at - timer;
+				if( policy->preempt( state, &running, &arrived ) )
+				{
+					end = at;
+				}
+			}
+		}
+
+		runningJob.runTime = end - timer;
+		runningJob.remaining -= runningJob.runTime;
+		runningJob.stopped = end;
+		runningJob.lastCpu = 0;
+		timer = end;
+
+		/* A process pre-empted as soon as it was switched in never ran */
+		if( gantt != NULL && runningJob.runTime > 0 )
+		{
+			ganttAddBlock( gantt, runningJob.proc.pNo, runningJob.runTime );
+			SIM_STAT( counter.stats.ganttBlocks++; )
+		}
+		SIM_STAT( counter.stats.events++; )
+		SIM_STAT( counter.busy += runningJob.runTime; )
+
+		/* Process was stopped early. It goes back in the queue */
+		if( runningJob.remaining > 0 )
+		{
+			runningJob.preemptions++;
+			policy->enqueue( state, &runningJob );
+			numReady++;
+			SIM_STAT( counter.stats.preemptions++; )
+			SIM_STAT( counter.stats.queueOps++; )
+		}
+		/* Process's burst time is completed. Its times are final */
+		else
+		{
+			turnTime += timer - runningJob.proc.arrivalTime;
+			waitTime += timer - runningJob.proc.arrivalTime - runningJob.proc.burstTime;
+			if( config->export != NULL )
+			{
+				simExport( config->export, &runningJob, timer );
+			}
+			simProgress( config, &done, waitTime, turnTime );
+		}
+	}
+
+	outResult->waitTime = waitTime;
+	outResult->turnTime = turnTime;
+	outResult->count = psSize( src );
+	outResult->end = ( outResult->count > 0 ) ? timer : 0;
+	outResult->overhead = overheadTime;
+	simCountFinish( &counter, 1, outResult );
+	if( outGantt != NULL )
+	{
+		*outGantt = gantt;
+	}
+
+	/* Clean up our used memory */
+	policy->destroy( state );
+}
+
+
+/* One CPU of an SMP simulation.
+ * queue - The CPU's own ready queue. NULL for a global placement.
+ * numQueued - The number of processes in queue.
+ * running - TRUE while a process is on the CPU.
+ * job - The process on the CPU.
+ * start, end - When its slice started, after any overhead, and when it
+ * 	will stop.
+ * busy - The total time spent running processes.
+ * heapPos - Where the CPU is in the stop heap while running.
+ * idlePos - Where the CPU is in the idle list while not running.
+ * woken - TRUE while the CPU is on the wake list.
+ * lastPNo - The process the CPU ran last, or -1 if none. */
+struct simCpu
+{
+	void *queue;
+	size_t numQueued;
+	int running;
+	struct simJob job;
+	simTime start;
+	simTime end;
+	simTime busy;
+	size_t heapPos;
+	size_t idlePos;
+	int woken;
+	int64_t lastPNo;
+};
+
+
+/* The state of an SMP simulation.
+ * config - The settings.
+ * policy, placement - What is being simulated.
+ * cpus, numCpus - The CPUs.
+ * global, numGlobal - The shared ready queue and the number of processes
+ * 	in it, for a global placement.
+ * totalQueued - The number of processes in every ready queue together.
+ * heap, heapSize - The numbers of the running CPUs, as a binary min-heap
+ * 	ordered by when they stop and then by number.
+ * idle, numIdle - The numbers of the CPUs that are not running.
+ * wake, numWake - The idle CPUs that have been given work since the last
+ * 	dispatch.
+ * nextCpu - The CPU the next arrival is dealt to, for a steal placement.
+ * export - Where to write each process's result, or NULL.
+ * waitTime, turnTime, end, overhead - The totals so far.
+ * done - The number of processes completed so far.
+ * counter - The counters so far. */
+struct simSmp
+{
+	const struct simConfig *config;
+	const struct simPolicy *policy;
+	int placement;
+	struct simCpu *cpus;
+	int numCpus;
+	void *global;
+	size_t numGlobal;
+	size_t totalQueued;
+	int *heap;
+	size_t heapSize;
+	int *idle;
+	size_t numIdle;
+	int *wake;
+	size_t numWake;
+	int nextCpu;
+	Export export;
+	simTime waitTime;
+	simTime turnTime;
+	simTime end;
+	simTime overhead;
+	size_t done;
+	struct simCounter counter;
+};
+
+/* TRUE if CPU a stops before CPU b */
+#define SIM_STOPS_BEFORE( smp, a, b ) ( (smp)->cpus[a].end < (smp)->cpus[b].end || ( (smp)->cpus[a].end == (smp)->cpus[b].end && (a) < (b) ) )
+
+
+/****
+ *  smpHeapUp
+ *  Description: Moves a CPU up the stop heap until its parent stops before
+ *  	it does.
+ *
+ *  struct simSmp *smp - The simulation.
+ *  size_t pos - The CPU's position in the heap.
+ *
+ *  Returns nothing.
+ */
+static void smpHeapUp( struct simSmp *smp, size_t pos )
+{
+	int cpu = smp->heap[pos];
+
+	while( pos > 0 && SIM_STOPS_BEFORE( smp, cpu, smp->heap[( pos - 1 ) / 2] ) )
+	{
+		smp->heap[pos] = smp->heap[( pos - 1 ) / 2];
+		smp->cpus[smp->heap[pos]].heapPos = pos;
+		pos = ( pos - 1 ) / 2;
+	}
+	smp->heap[pos] = cpu;
+	smp->cpus[cpu].heapPos = pos;
+}
+
+
+/****
+ *  smpHeapPop
+ *  Description: Takes the CPU that stops first off the stop heap.
+ *
+ *  struct simSmp *smp - The simulation. The heap must not be empty.
+ *
+ *  Returns the CPU's number.
+ */
+static int smpHeapPop( struct simSmp *smp )
+{
+	int first = smp->heap[0];
+	int cpu;
+	size_t pos = 0;
+
+	smp->heapSize--;
+	if( smp->heapSize > 0 )
+	{
+		/* Sift the last CPU down from the top */
+		cpu = smp->heap[smp->heapSize];
+		while( 2 * pos + 1 < smp->heapSize )
+		{
+			size_t child = 2 * pos + 1;
+
+			if( child + 1 < smp->heapSize && SIM_STOPS_BEFORE( smp, smp->heap[child + 1], smp->heap[child] ) )
+			{
+				child++;
+			}
+			if( !SIM_STOPS_BEFORE( smp, smp->heap[child], cpu ) )
+			{
+				break;
+			}
+			smp->heap[pos] = smp->heap[child];
+			smp->cpus[smp->heap[pos]].heapPos = pos;
+			pos = child;
+		}
+		smp->heap[pos] = cpu;
+		smp->cpus[cpu].heapPos = pos;
+	}
+
+	return first;
+}
+
+
+/****
+ *  smpIdleRemove
+ *  Description: Takes a CPU off the idle list.
+ *
+ *  struct simSmp *smp - The simulation.
+ *  int cpu - The CPU. Must be idle.
+ *
+ *  Returns nothing.
+ */
+static void smpIdleRemove( struct simSmp *smp, int cpu )
+{
+	int last = smp->idle[smp->numIdle - 1];
+
+	smp->idle[smp->cpus[cpu].idlePos] = last;
+	smp->cpus[last].idlePos = smp->cpus[cpu].idlePos;
+	smp->numIdle--;
+}
+
+
+/****
+ *  smpQueue
+ *  Description: Finds the ready queue that a CPU takes its work from.
+ *
+ *  struct simSmp *smp - The simulation.
+ *  int cpu - The CPU.
+ *
+ *  Returns the policy state of the queue.
+ */
+static void *smpQueue( struct simSmp *smp, int cpu )
+{
+	return ( smp->placement == SIM_PLACE_GLOBAL ) ? smp->global : smp->cpus[cpu].queue;
+}
+
+
+/****
+ *  smpWake
+ *  Description: Puts an idle CPU with work in its own ready queue on the
+ *  	wake list, so that it will be started.
+ *
+ *  struct simSmp *smp - The simulation.
+ *  int cpu - The CPU. Nothing is done if it is running, already on the
+ *  	list or has no work of its own.
+ *
+ *  Returns nothing.
+ */
+static void smpWake( struct simSmp *smp, int cpu )
+{
+	struct simCpu *c = &smp->cpus[cpu];
+
+	if( !c->running && !c->woken && c->numQueued > 0 )
+	{
+		c->woken = TRUE;
+		smp->wake[smp->numWake++] = cpu;
+	}
+}
+
+
+/****
+ *  smpEnqueue
+ *  Description: Adds a process to the ready queue a CPU takes its work
+ *  	from. An idle CPU is put on the wake list so that it will be started.
+ *
+ *  struct simSmp *smp - The simulation.
+ *  int cpu - The CPU.
+ *  const struct simJob *job - The process.
+ *
+ *  Returns nothing.
+ */
+static void smpEnqueue( struct simSmp *smp, int cpu, const struct simJob *job )
+{
+	struct simCpu *c = &smp->cpus[cpu];
+
+	smp->policy->enqueue( smpQueue( smp, cpu ), job );
+	smp->totalQueued++;
+	SIM_STAT( smp->counter.stats.queueOps++; )
+	if( smp->placement == SIM_PLACE_GLOBAL )
+	{
+		smp->numGlobal++;
+	}
+	else
+	{
+		c->numQueued++;
+		smpWake( smp, cpu );
+	}
+}
+
+
+/****
+ *  smpTake
+ *  Description: Takes the next process from a ready queue.
+ *
+ *  struct simSmp *smp - The simulation.
+ *  int from - The CPU whose ready queue to take the process from. It must
+ *  	not be empty.
+ *  struct simJob *outJob - Where to place the process.
+ *
+ *  Returns nothing.
+ */
+static void smpTake( struct simSmp *smp, int from, struct simJob *outJob )
+{
+	smp->policy->pickNext( smpQueue( smp, from ), outJob );
+	smp->totalQueued--;
+	SIM_STAT( smp->counter.stats.queueOps++; )
+	if( smp->placement == SIM_PLACE_GLOBAL )
+	{
+		smp->numGlobal--;
+	}
+	else
+	{
+		smp->cpus[from].numQueued--;
+	}
+}
+
+
+/****
+ *  smpIdleFor
+ *  Description: Chooses which idle CPU should run a process that any of
+ *  	them could take. The CPU it last ran on is chosen if that is idle, as
+ *  	its cache may still be warm.
+ *
+ *  struct simSmp *smp - The simulation. At least one CPU must be idle.
+ *  const struct simJob *job - The process.
+ *
+ *  Returns the CPU.
+ */
+static int smpIdleFor( struct simSmp *smp, const struct simJob *job )
+{
+	int cpu = smp->idle[smp->numIdle - 1];
+
+	if( job->lastCpu >= 0 && !smp->cpus[job->lastCpu].running )
+	{
+		cpu = job->lastCpu;
+	}
+
+	return cpu;
+}
+
+
+/****
+ *  smpStart
+ *  Description: Starts an idle CPU running a process just taken from a
+ *  	ready queue.
+ *
+ *  struct simSmp *smp - The simulation.
+ *  int cpu - The CPU. Must be idle.
+ *  int from - The CPU whose ready queue the process was taken from.
+ *  const struct simJob *job - The process.
+ *  simTime now - The current time.
+ *
+ *  Returns nothing.
+ */
+static void smpStart( struct simSmp *smp, int cpu, int from, const struct simJob *job, simTime now )
+{
+	struct simCpu *c = &smp->cpus[cpu];
+	simTime slice, overhead;
+
+	c->job = *job;
+	SIM_STAT(
+		if( c->job.proc.pNo != c->lastPNo )
+		{
+			smp->counter.stats.switches++;
+		}
+	)
+
+	/* The CPU switches to it before it runs */
+	overhead = simOverhead( smp->config, &c->job, cpu, c->lastPNo, now );
+	c->lastPNo = c->job.proc.pNo;
+	smp->overhead += overhead;
+	if( c->job.firstRun < 0 )
+	{
+		c->job.firstRun = now + overhead;
+	}
+
+	slice = smp->policy->quantum( smpQueue( smp, from ), &c->job );
+	if( slice > c->job.remaining )
+	{
+		slice = c->job.remaining;
+	}
+	c->start = now + overhead;
+	c->end = c->start + slice;
+	c->running = TRUE;
+	smpIdleRemove( smp, cpu );
+	smp->heap[smp->heapSize] = cpu;
+	smpHeapUp( smp, smp->heapSize++ );
+}
+
+
+/****
+ *  smpStop
+ *  Description: Stops the CPU at the top of the stop heap. Its process
+ *  	either completes or goes back to a ready queue.
+ *
+ *  struct simSmp *smp - The simulation.
+ *
+ *  Returns nothing.
+ */
+static void smpStop( struct simSmp *smp )
+{
+	int cpu = smpHeapPop( smp );
+	struct simCpu *c = &smp->cpus[cpu];
+
+	c->job.runTime = c->end - c->start;
+	c->job.remaining -= c->job.runTime;
+	c->job.stopped = c->end;
+	c->job.lastCpu = cpu;
+	c->busy += c->job.runTime;
+	c->running = FALSE;
+	c->idlePos = smp->numIdle;
+	smp->idle[smp->numIdle++] = cpu;
+
+	if( c->job.remaining > 0 )
+	{
+		c->job.preemptions++;
+		smpEnqueue( smp, cpu, &c->job );
+		SIM_STAT( smp->counter.stats.preemptions++; )
+	}
+	else
+	{
+		smp->turnTime += c->end - c->job.proc.arrivalTime;
+		smp->waitTime += c->end - c->job.proc.arrivalTime - c->job.proc.burstTime;
+		smp->end = c->end;
+		if( smp->export != NULL )
+		{
+			simExport( smp->export, &c->job, c->end );
+		}
+		simProgress( smp->config, &smp->done, smp->waitTime, smp->turnTime );
+	}
+
+	/* It may have work of its own waiting */
+	if( smp->placement != SIM_PLACE_GLOBAL )
+	{
+		smpWake( smp, cpu );
+	}
+}
+
+
+/****
+ *  smpLeft
+ *  Description: Works out how long the process on a CPU has left to run.
+ *  	It has used none of its slice while the CPU is still switching to it.
+ *
+ *  const struct simCpu *c - The CPU. Must be running.
+ *  simTime now - The current time.
+ *
+ *  Returns the time left.
+ */
+static simTime smpLeft( const struct simCpu *c, simTime now )
+{
+	return c->job.remaining - ( now > c->start ? now - c->start : 0 );
+}
+
+
+/****
+ *  smpPreempt
+ *  Description: Asks the policy whether a process that has just arrived
+ *  	should pre-empt a CPU, and if so makes the CPU stop now, or as soon
+ *  	as it has switched to its process.
+ *
+ *  struct simSmp *smp - The simulation.
+ *  int cpu - The CPU. Nothing is done if it is idle.
+ *  const struct simJob *arrived - The process that arrived.
+ *  simTime now - The current time.
+ *
+ *  Returns nothing.
+ */
+static void smpPreempt( struct simSmp *smp, int cpu, const struct simJob *arrived, simTime now )
+{
+	struct simCpu *c = &smp->cpus[cpu];
+	struct simJob running;
+
+	if( c->running && c->end > now )
+	{
+		running = c->job;
+		running.remaining = smpLeft( c, now );
+		if( smp->policy->preempt( smpQueue( smp, cpu ), &running, arrived ) )
+		{
+			/* It stops now. Moving it up the heap is enough as it can
+			 * only stop sooner */
+			c->end = ( now > c->start ) ? now : c->start;
+			smpHeapUp( smp, c->heapPos );
+		}
+	}
+}
+
+
+/****
+ *  smpArrive
+ *  Description: Places a process that has just arrived on a CPU's ready
+ *  	queue, or the global one, as the placement says.
+ *
+ *  struct simSmp *smp - The simulation.
+ *  const struct simJob *job - The process.
+ *
+ *  Returns nothing.
+ */
+static void smpArrive( struct simSmp *smp, const struct simJob *job )
+{
+	simTime now = job->proc.arrivalTime;
+	int cpu = 0;
+	int i;
+
+	if( smp->placement == SIM_PLACE_STEAL )
+	{
+		cpu = smp->nextCpu;
+		smp->nextCpu = ( smp->nextCpu + 1 ) % smp->numCpus;
+	}
+	else if( smp->placement == SIM_PLACE_PUSH )
+	{
+		size_t load, leastLoad = (size_t)-1;
+
+		for( i = 0; i < smp->numCpus; i++ )
+		{
+			load = smp->cpus[i].numQueued + smp->cpus[i].running;
+			if( load < leastLoad )
+			{
+				leastLoad = load;
+				cpu = i;
+			}
+		}
+	}
+	else if( smp->policy->preempt != NULL )
+	{
+		simTime most = -1;
+
+		/* A process on the global queue can pre-empt any CPU. The one
+		 * with the most left to run is the one to ask about */
+		for( i = 0; i < smp->numCpus; i++ )
+		{
+			if( smp->cpus[i].running && smpLeft( &smp->cpus[i], now ) > most )
+			{
+				most = smpLeft( &smp->cpus[i], now );
+				cpu = i;
+			}
+		}
+	}
+
+	smpEnqueue( smp, cpu, job );
+
+	/* Pre-empting is only worth it when the process would otherwise wait.
+	 * Idle CPUs are given work once everything at this moment has
+	 * happened, and with a global queue or stealing any of them can take
+	 * it. A pushed process can only ever run on the CPU it was pushed to */
+	if( smp->policy->preempt != NULL )
+	{
+		if( ( smp->placement == SIM_PLACE_GLOBAL && smp->numGlobal > smp->numIdle ) ||
+			( smp->placement == SIM_PLACE_STEAL && smp->totalQueued > smp->numIdle ) ||
+			smp->placement == SIM_PLACE_PUSH )
+		{
+			smpPreempt( smp, cpu, job, now );
+		}
+	}
+}
+
+
+/****
+ *  smpDispatch
+ *  Description: Starts every idle CPU that has work it can take.
+ *
+ *  struct simSmp *smp - The simulation.
+ *  simTime now - The current time.
+ *
+ *  Returns nothing.
+ */
+static void smpDispatch( struct simSmp *smp, simTime now )
+{
+	struct simJob job;
+	size_t i;
+
+	if( smp->placement == SIM_PLACE_GLOBAL )
+	{
+		while( smp->numIdle > 0 && smp->numGlobal > 0 )
+		{
+			smpTake( smp, 0, &job );
+			smpStart( smp, smpIdleFor( smp, &job ), 0, &job, now );
+		}
+	}
+	else
+	{
+		/* CPUs that were given work while idle run it themselves */
+		for( i = 0; i < smp->numWake; i++ )
+		{
+			int cpu = smp->wake[i];
+
+			smp->cpus[cpu].woken = FALSE;
+			if( !smp->cpus[cpu].running && smp->cpus[cpu].numQueued > 0 )
+			{
+				smpTake( smp, cpu, &job );
+				smpStart( smp, cpu, cpu, &job, now );
+			}
+		}
+		smp->numWake = 0;
+
+		/* Any work left is queued behind a running CPU. Idle CPUs steal
+		 * it from whichever CPU has the most */
+		while( smp->placement == SIM_PLACE_STEAL && smp->numIdle > 0 && smp->totalQueued > 0 )
+		{
+			int victim = 0;
+			int cpu;
+
+			for( cpu = 1; cpu < smp->numCpus; cpu++ )
+			{
+				if( smp->cpus[cpu].numQueued > smp->cpus[victim].numQueued )
+				{
+					victim = cpu;
+				}
+			}
+			smpTake( smp, victim, &job );
+			smpStart( smp, smpIdleFor( smp, &job ), victim, &job, now );
+		}
+	}
+}
+
+
+void simRunSmp( ProcSource src, const struct simPolicy *policy, const struct simConfig *config, simTime *outBusy, struct simResult *outResult )
+{
+	struct simSmp smp;
+	int i;
+
+	assert( src != NULL );
+	assert( policy != NULL && config != NULL );
+	assert( config->numCpus > 0 );
+	assert( config->placement >= 0 && config->placement < SIM_NUM_PLACEMENTS );
+	assert( config->dispatch >= 0 && config->refill >= 0 && config->cold > 0 );
+	assert( outResult != NULL );
+
+	simCountStart( &smp.counter );
+	outResult->start = ( psPeek( src ) != NULL ) ? psPeek( src )->arrivalTime : 0;
+
+	smp.config = config;
+	smp.policy = policy;
+	smp.placement = config->placement;
+	smp.numCpus = config->numCpus;
+	smp.cpus = malloc( smp.numCpus * sizeof *smp.cpus );
+	smp.heap = malloc( smp.numCpus * sizeof *smp.heap );
+	smp.idle = malloc( smp.numCpus * sizeof *smp.idle );
+	smp.wake = malloc( smp.numCpus * sizeof *smp.wake );
+	SIM_STAT( simAllocs += 4; )
+	smp.global = NULL;
+	smp.numGlobal = 0;
+	smp.totalQueued = 0;
+	smp.heapSize = 0;
+	smp.numIdle = 0;
+	smp.numWake = 0;
+	smp.nextCpu = 0;
+	smp.export = config->export;
+	smp.waitTime = smp.turnTime = 0;
+	smp.end = 0;
+	smp.overhead = 0;
+	smp.done = 0;
+
+	/* One ready queue for everyone, or one each sized for an even share */
+	if( smp.placement == SIM_PLACE_GLOBAL )
+	{
+		smp.global = policy->create( psSize( src ), config );
+	}
+	for( i = 0; i < smp.numCpus; i++ )
+	{
+		struct simCpu *c = &smp.cpus[i];
+
+		c->queue = ( smp.placement == SIM_PLACE_GLOBAL ) ? NULL : policy->create( psSize( src ) / smp.numCpus, config );
+		c->numQueued = 0;
+		c->running = FALSE;
+		c->busy = 0;
+		c->woken = FALSE;
+		c->lastPNo = -1;
+		c->idlePos = smp.numIdle;
+		smp.idle[smp.numIdle++] = i;
+	}
+
+	/* Take the events in order of time, with CPUs stopping before processes
+	 * arriving at the same moment. Once everything at one moment has
+	 * happened the idle CPUs are given work */
+	while( smp.heapSize > 0 || psPeek( src ) != NULL )
+	{
+		simTime now;
+
+		if( smp.heapSize > 0 && ( psPeek( src ) == NULL || smp.cpus[smp.heap[0]].end <= psPeek( src )->arrivalTime ) )
+		{
+			now = smp.cpus[smp.heap[0]].end;
+			smpStop( &smp );
+		}
+		else
+		{
+			struct simJob job;
+
+			simTake( src, &job );
+			now = job.proc.arrivalTime;
+			smpArrive( &smp, &job );
+		}
+		SIM_STAT( smp.counter.stats.events++; )
+		SIM_STAT( simCountQueue( &smp.counter, smp.totalQueued ); )
+
+		if( !( smp.heapSize > 0 && smp.cpus[smp.heap[0]].end == now ) &&
+			!( psPeek( src ) != NULL && psPeek( src )->arrivalTime == now ) )
+		{
+			smpDispatch( &smp, now );
+		}
+	}
+
+	outResult->waitTime = smp.waitTime;
+	outResult->turnTime = smp.turnTime;
+	outResult->count = psSize( src );
+	outResult->end = smp.end;
+	outResult->overhead = smp.overhead;
+
+	/* Clean up our used memory */
+	for( i = 0; i < smp.numCpus; i++ )
+	{
+		SIM_STAT( smp.counter.busy += smp.cpus[i].busy; )
+		if( outBusy != NULL )
+		{
+			outBusy[i] = smp.cpus[i].busy;
+		}
+		if( smp.cpus[i].queue != NULL )
+		{
+			policy->destroy( smp.cpus[i].queue );
+		}
+	}
+	if( smp.global != NULL )
+	{
+		policy->destroy( smp.global );
+	}
+	free( smp.cpus );
+	free( smp.heap );
+	free( smp.idle );
+	free( smp.wake );
+	simCountFinish( &smp.counter, smp.numCpus, outResult );
+}
+
+
+/* The names of the placements, in order of their SIM_PLACE_ values */
+static const char *simPlacementNames[SIM_NUM_PLACEMENTS] = { "global", "steal", "push" };
+
+
+const char *simPlacementName( int placement )
+{
+	assert( placement >= 0 && placement < SIM_NUM_PLACEMENTS );
+
+	return simPlacementNames[placement];
+}
+
+
+int simPlacementFromName( const char *name )
+{
+	int placement = -1;
+	int i;
+
+	assert( name != NULL );
+
+	for( i = 0; i < SIM_NUM_PLACEMENTS; i++ )
+	{
+		if( strcmp( name, simPlacementNames[i] ) == 0 )
+		{
+			placement = i;
+		}
+	}
+
+	return placement;
+}
+
+
+double simUtilisation( const struct simResult *result, int numCpus, double *outOverhead )
+{
+	double cpuTime, utilisation = 0.0;
+
+	assert( result != NULL && numCpus > 0 );
+
+	/* Every process's burst is the difference between its turnaround and
+	 * waiting times */
+	cpuTime = (double)numCpus * ( result->end - result->start );
+	if( outOverhead != NULL )
+	{
+		*outOverhead = 0.0;
+	}
+	if( cpuTime > 0.0 )
+	{
+		utilisation = ( result->turnTime - result->waitTime ) / cpuTime;
+		if( outOverhead != NULL )
+		{
+			*outOverhead = result->overhead / cpuTime;
+		}
+	}
+
+	return utilisation;
+}
+
+
+void simStatsFormat( const struct simStats *stats, char *outBuf )
+{
+	assert( stats != NULL && outBuf != NULL );
+
+#ifdef SIM_STATS
+	snprintf( outBuf, SIM_STATS_LEN, "events=%ld idle=%lld switches=%ld preemptions=%ld max_queue=%lu mean_queue=%f queue_ops=%ld gantt_blocks=%ld allocations=%ld",
+		stats->events, (long long)stats->idleTime, stats->switches, stats->preemptions, (unsigned long)stats->maxQueue,
+		stats->meanQueue, stats->queueOps, stats->ganttBlocks, stats->allocations );
+#else
+	strcpy( outBuf, "no counters (SIM_STATS is not defined in common.h)" );
+#endif
+}
+
+
+void simRunAverages( ProcSource src, const struct simPolicy *policy, const struct simConfig *config, double *outAveWait, double *outAveTurn )
+{
+	struct simResult result;
+
+	assert( outAveWait != NULL && outAveTurn != NULL );
+
+	simRun( src, policy, config, NULL, &result );
+	calcAverages( result.waitTime, result.turnTime, result.count, outAveWait, outAveTurn );
+}
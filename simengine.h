@@ -0,0 +1,318 @@
+/* simengine.h
+ * The event driven simulation loop shared by every
+ * scheduling policy. The engine admits arrivals,
+ * keeps the clock, builds the gantt chart and sums
+ * the waiting and turnaround times. A policy only
+ * decides which ready process runs next and for
+ * how long, through a small table of callbacks over
+ * its own ready queue, so each policy can keep its
+ * ready processes in whatever structure suits it.
+ * The same policies can also be run on several
+ * CPUs at once.
+ */
+
+#ifndef SIMENGINE_H
+#define SIMENGINE_H
+
+#include <stdlib.h>
+#include "common.h"
+#include "Gantt.h"
+#include "proc.h"
+#include "ProcSource.h"
+#include "Export.h"
+#include "simcalc.h"
+
+/* How an SMP simulation places processes on CPUs.
+ * SIM_PLACE_GLOBAL - One ready queue shared by every CPU.
+ * SIM_PLACE_STEAL - A ready queue per CPU. Arrivals are dealt out to the
+ * 	CPUs in turn, and a CPU with nothing to run steals from the CPU with
+ * 	the longest queue.
+ * SIM_PLACE_PUSH - A ready queue per CPU. Each arrival is pushed to the CPU
+ * 	with the fewest processes, and is never moved after that. */
+#define SIM_PLACE_GLOBAL 0
+#define SIM_PLACE_STEAL 1
+#define SIM_PLACE_PUSH 2
+#define SIM_NUM_PLACEMENTS 3
+
+
+/* A process as seen by the engine and the policies.
+ * struct proc proc - A copy of the process's information.
+ * simTime runTime - The amount of time that the process ran for
+ * 	CONTINUOUSLY in its most recent slice.
+ * simTime remaining - The remaining amount of time until all of the
+ * 	process's burst time is exceeded.
+ * simTime firstRun - When the process first ran, or -1 if it has not yet.
+ * simTime stopped - When it last stopped running, or -1 if it has not yet
+ * 	run.
+ * int preemptions - How many times it has been stopped before completing.
+ * int lastCpu - The CPU it last ran on, or -1 if it has not yet run.
+ * The two ints are kept together so the job is not padded out, as jobs are
+ * copied in and out of the ready queues all the time.
+ */
+struct simJob
+{
+	struct proc proc;
+	simTime runTime;
+	simTime remaining;
+	simTime firstRun;
+	simTime stopped;
+	int preemptions;
+	int lastCpu;
+};
+
+
+/* How long a process has to be off the CPU, by default, for its cache to
+ * go completely cold */
+#define SIM_DEFAULT_COLD 100
+
+/* How many processes complete, by default, between the running averages
+ * printed while a stream is simulated */
+#define SIM_DEFAULT_PROGRESS 1000000
+
+
+/* The settings of a simulation. simConfigDefaults sets every one.
+ * quantum - The round robin quantum. Ignored by policies without one.
+ * numCpus - The number of CPUs for simRunSmp. Ignored by simRun.
+ * placement - One of the SIM_PLACE_ values, for simRunSmp.
+ * export - Where to write the result of each process as it completes. NULL
+ * 	if they are not wanted.
+ * dispatch - The time it takes a CPU to switch to a different process from
+ * 	the one it ran last.
+ * refill - The time it takes a process to refill a cold cache when it
+ * 	starts running. A process that has never run, or that last ran on
+ * 	another CPU, always pays all of it.
+ * cold - How long a process has to be off its CPU for its cache to go
+ * 	completely cold. A shorter time costs the same share of refill.
+ * 	Positive.
+ * progress - How many processes complete between the running averages
+ * 	printed on stderr while the simulation goes on. Zero for none. */
+struct simConfig
+{
+	int quantum;
+	int numCpus;
+	int placement;
+	Export export;
+	int dispatch;
+	int refill;
+	int cold;
+	size_t progress;
+};
+
+
+/* The room simStatsFormat needs */
+#define SIM_STATS_LEN 512
+
+
+/* What a simulation did, to help explain how long it took. Only counted
+ * when SIM_STATS is defined in common.h, and all zero otherwise.
+ * events - Arrivals taken from the source plus slices that ended.
+ * idleTime - CPU time from the first arrival to the last completion with
+ * 	nothing to run, summed over every CPU. Overhead is not idle.
+ * switches - Times a CPU started a different process from the one it ran
+ * 	last.
+ * preemptions - Slices that ended before their process completed, at the
+ * 	end of a quantum or on a pre-empting arrival.
+ * maxQueue, meanQueue - The most processes waiting in the ready queues at
+ * 	once, and the mean over every event.
+ * queueOps - Processes added to and taken from the ready queues.
+ * ganttBlocks - Blocks added to the gantt chart, idle ones included.
+ * allocations - Heap allocations made by the ready queues, the gantt chart
+ * 	and the engine itself. */
+struct simStats
+{
+	long events;
+	simTime idleTime;
+	long switches;
+	long preemptions;
+	size_t maxQueue;
+	double meanQueue;
+	long queueOps;
+	long ganttBlocks;
+	long allocations;
+};
+
+
+/* The totals from a simulation.
+ * waitTime, turnTime - The total waiting and turnaround times.
+ * count - The number of processes simulated.
+ * start, end - The first arrival and the last completion. Both zero if
+ * 	there were no processes.
+ * overhead - The time spent switching processes and refilling caches,
+ * 	summed over every CPU. The processes spend it waiting.
+ * stats - What the simulation did. */
+struct simResult
+{
+	simTime waitTime;
+	simTime turnTime;
+	size_t count;
+	simTime start;
+	simTime end;
+	simTime overhead;
+	struct simStats stats;
+};
+
+
+/* A scheduling policy. state is whatever create returns, and is handed
+ * back to every other callback.
+ * create - Makes an empty ready queue with room for capacity processes.
+ * 	It may grow past that.
+ * destroy - Frees the ready queue.
+ * enqueue - Adds a process to the ready queue, either on arrival or when
+ * 	it is stopped before completing.
+ * pickNext - Removes the process to run next. Only called when there is
+ * 	one.
+ * quantum - How long the picked process may run before the next decision
+ * 	is made. The engine never runs it past its remaining time.
+ * preempt - Called when a process arrives, after it has been enqueued,
+ * 	while another runs. Returns TRUE to stop the running process there.
+ * 	running->remaining is what it has left at that moment. NULL for a
+ * 	policy that never pre-empts on arrival. */
+struct simPolicy
+{
+	void *(*create)( size_t capacity, const struct simConfig *config );
+	void (*destroy)( void *state );
+	void (*enqueue)( void *state, const struct simJob *job );
+	void (*pickNext)( void *state, struct simJob *outJob );
+	simTime (*quantum)( void *state, const struct simJob *job );
+	int (*preempt)( void *state, const struct simJob *running, const struct simJob *arrived );
+};
+
+
+/****
+ *  simConfigDefaults
+ *  Description: Sets up the settings for a simulation on one CPU with a
+ *  	global queue, no export, no running averages and switches that cost
+ *  	nothing, which can then be changed as needed.
+ *
+ *  struct simConfig *outConfig - The settings. Must be non-null.
+ *  int quantum - The round robin quantum.
+ *
+ *  Returns nothing.
+ */
+void simConfigDefaults( struct simConfig *outConfig, int quantum );
+
+
+/****
+ *  simRun
+ *  Description: Simulates a policy on a source of processes. The clock
+ *  	jumps straight from one scheduling decision to the next: a completion,
+ *  	the end of a quantum, an arrival that pre-empts, or, when the CPU is
+ *  	idle, the next arrival. Processes that arrive while one runs join the
+ *  	ready queue before it does, and those arriving at the very moment it
+ *  	stops join after it. Each process's waiting and turnaround times are
+ *  	summed as it completes. Before a process runs the CPU spends the
+ *  	overhead config sets out on switching to it, shown as GANTT_OVERHEAD
+ *  	blocks in the chart. That can not be pre-empted; a process arriving
+ *  	during it can only pre-empt once the switch is done.
+ *
+ *  ProcSource src - The processes to simulate, in order of arrival. Must be
+ *  	non-null.
+ *  const struct simPolicy *policy - The policy. Must be non-null.
+ *  const struct simConfig *config - The settings handed to the policy. Must
+ *  	be non-null.
+ *  Gantt *outGantt - Where to place a gantt chart of the simulation. It
+ *  	should be freed with ganttDestroy. NULL if no chart is wanted.
+ *  struct simResult *outResult - Where to place the totals. Must be
+ *  	non-null.
+ *
+ *  Returns nothing.
+ */
+void simRun( ProcSource src, const struct simPolicy *policy, const struct simConfig *config, Gantt *outGantt, struct simResult *outResult );
+
+
+/****
+ *  simRunSmp
+ *  Description: Simulates a policy on several CPUs. Each CPU runs one
+ *  	process at a time, and processes are placed on CPUs as
+ *  	config->placement says. Like simRun, the clock jumps from one event to
+ *  	the next. The CPUs waiting to stop are kept in a heap ordered by when
+ *  	they stop, so an event costs O(log numCpus), plus O(numCpus) for a push
+ *  	placement, a steal, or an arrival that may pre-empt on the global
+ *  	queue. At any one moment CPUs stop before processes arrive. Overhead is
+ *  	charged as for simRun. With one CPU the results are the same as
+ *  	simRun's.
+ *
+ *  ProcSource src, const struct simPolicy *policy - As for simRun.
+ *  const struct simConfig *config - The settings. config->numCpus must be
+ *  	positive. Must be non-null.
+ *  simTime *outBusy - Where to place the time each CPU spent running
+ *  	processes, not counting overhead. Must have room for config->numCpus entries. NULL if not
+ *  	wanted.
+ *  struct simResult *outResult - Where to place the totals. Must be
+ *  	non-null.
+ *
+ *  Returns nothing.
+ */
+void simRunSmp( ProcSource src, const struct simPolicy *policy, const struct simConfig *config, simTime *outBusy, struct simResult *outResult );
+
+
+/****
+ *  simPlacementName
+ *  Description: The name of a placement, as used on the command line.
+ *
+ *  int placement - One of the SIM_PLACE_ values.
+ *
+ *  Returns "global", "steal" or "push".
+ */
+const char *simPlacementName( int placement );
+
+
+/****
+ *  simPlacementFromName
+ *  Description: Looks up a placement by name.
+ *
+ *  const char *name - "global", "steal" or "push".
+ *
+ *  Returns one of the SIM_PLACE_ values, or -1 if the name is not known.
+ */
+int simPlacementFromName( const char *name );
+
+
+/****
+ *  simUtilisation
+ *  Description: Works out how much of the CPUs' time went on running
+ *  	processes, and how much on overhead, from the first arrival to the
+ *  	last completion.
+ *
+ *  const struct simResult *result - The result of a simulation. Must be
+ *  	non-null.
+ *  int numCpus - The number of CPUs it simulated.
+ *  double *outOverhead - Where to place the fraction spent on overhead.
+ *  	NULL if not wanted.
+ *
+ *  Returns the fraction spent running processes. Both are zero if there
+ *  	were no processes.
+ */
+double simUtilisation( const struct simResult *result, int numCpus, double *outOverhead );
+
+
+/****
+ *  simStatsFormat
+ *  Description: Writes the counters from a simulation as one line of
+ *  	name=value pairs, or says that they were not compiled in.
+ *
+ *  const struct simStats *stats - The counters. Must be non-null.
+ *  char *outBuf - Where to write the line, without a newline. Must have room
+ *  	for SIM_STATS_LEN characters.
+ *
+ *  Returns nothing.
+ */
+void simStatsFormat( const struct simStats *stats, char *outBuf );
+
+
+/****
+ *  simRunAverages
+ *  Description: Simulates a policy on a source of processes without a gantt
+ *  	chart and works out the averages.
+ *
+ *  ProcSource src, const struct simPolicy *policy,
+ *  const struct simConfig *config - As for simRun.
+ *  double *outAveWait, *outAveTurn - Where to place the averages. Zero if
+ *  	there are no processes. Must be non-null.
+ *
+ *  Returns nothing.
+ */
+void simRunAverages( ProcSource src, const struct simPolicy *policy, const struct simConfig *config, double *outAveWait, double *outAveTurn );
+
+
+#endif
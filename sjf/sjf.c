@@ -6,19 +6,99 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 #include "../LList.h"
 #include "../common.h"
 #include "../sjfsim.h"
 
 #define FILENAME_LEN 10
+/* The room needed after the filename for the name of an export */
+#define EXPORT_NAME_EXTRA 16
 
 
-int main( void )
+int main( int argc, char *argv[] )
 {
 	/* Filenames are assumed to be no longer that 10 characters */
 	char fileName[FILENAME_LEN + 1];
 	int fileError;
+	int stream = FALSE;
+	int showStats = FALSE;
+	int exportFormat = -1;
+	long progress = -1;
+	int direct;
+	struct simConfig config;
+	simTime *busy;
+	int opt;
+
+	simConfigDefaults( &config, 0 );
+
+	/* -s streams each file instead of loading it. The file must already
+	 * be in order of arrival. -n simulates that many CPUs, placing
+	 * processes on them as -m says. -c prints what each simulation did.
+	 * -x writes the result of every process to a file named after the
+	 * input, as csv or bin. -d and -r charge for switching processes: a
+	 * dispatch latency, and a cache refill cost that is paid in full once
+	 * a process has been off its CPU for the cold time. -p prints the
+	 * running averages on stderr each time that many more processes have
+	 * completed, which streams do every million by default */
+	while( ( opt = getopt( argc, argv, "sn:m:cx:d:r:p:" ) ) != -1 )
+	{
+		if( opt == 's' )
+		{
+			stream = TRUE;
+		}
+		else if( opt == 'c' )
+		{
+			showStats = TRUE;
+		}
+		else if( opt == 'x' && exportFormatFromName( optarg ) >= 0 )
+		{
+			exportFormat = exportFormatFromName( optarg );
+		}
+		else if( opt == 'd' && atoi( optarg ) >= 0 )
+		{
+			config.dispatch = atoi( optarg );
+		}
+		else if( opt == 'r' && sscanf( optarg, "%d,%d", &config.refill, &config.cold ) >= 1 &&
+			config.refill >= 0 && config.cold > 0 )
+		{
+			/* The cold time is optional */
+		}
+		else if( opt == 'n' && atoi( optarg ) > 0 )
+		{
+			config.numCpus = atoi( optarg );
+		}
+		else if( opt == 'm' && simPlacementFromName( optarg ) >= 0 )
+		{
+			config.placement = simPlacementFromName( optarg );
+		}
+		else if( opt == 'p' && atol( optarg ) >= 0 )
+		{
+			progress = atol( optarg );
+		}
+		else
+		{
+			fprintf( stderr, "Usage: %s [-s] [-c] [-x csv|bin] [-d latency] [-r refill[,cold]]\n"
+				"       [-n cpus] [-m global|steal|push] [-p completions]\n", argv[0] );
+			return 1;
+		}
+	}
+	busy = malloc( config.numCpus * sizeof *busy );
+	if( progress >= 0 )
+	{
+		config.progress = progress;
+	}
+	else if( stream )
+	{
+		config.progress = SIM_DEFAULT_PROGRESS;
+	}
+
+	/* The engine is called directly when its full result is wanted, or
+	 * when a loaded table is to show its running averages */
+	direct = config.numCpus > 1 || showStats || exportFormat >= 0 || config.dispatch > 0 || config.refill > 0 ||
+		( !stream && config.progress > 0 );
 
 	/* Loop until the user enters QUIT */
 	do
@@ -28,12 +108,82 @@ int main( void )
 
 		if( strcmp( fileName, "QUIT" ) != 0 )
 		{
-			LList procList;
-			int quantum;
+			ProcTable procTable;
+			ProcStream procStream;
+			double aveTurn, aveWait;
+			simTime span = 0;
+			struct simResult result;
+			size_t errLine;
 
-			/* Attempt to read the list of processes from the file */
-			procList = listCreate();
-			fileError = procReadFile( fileName, procList, &quantum );
+			/* Attempt to read the table of processes from the file, or
+			 * just its quantum if the file is to be streamed */
+			if( stream )
+			{
+				fileError = procStreamOpen( fileName, &procStream, &errLine );
+			}
+			else
+			{
+				fileError = procReadTableParallel( fileName, 0, &procTable, &errLine );
+			}
+
+			/* Processes read successfully. Run simulation. A stream can
+			 * still turn out to be badly formatted part way through */
+			if( fileError == PROC_NO_ERROR && direct )
+			{
+				ProcSource src;
+				char exportName[FILENAME_LEN + EXPORT_NAME_EXTRA];
+
+				src = stream ? psFromStream( procStream ) : psFromTable( procTable );
+				config.quantum = stream ? procStreamQuantum( procStream ) : ptQuantum( procTable );
+				if( exportFormat >= 0 )
+				{
+					sprintf( exportName, "%s.sjf.%s", fileName, exportFormatName( exportFormat ) );
+					config.export = exportOpen( exportName, exportFormat );
+					if( config.export == NULL )
+					{
+						printf( "Can not open file: %s\n", exportName );
+					}
+				}
+				if( config.numCpus > 1 )
+				{
+					simRunSmp( src, &sjfPolicy, &config, busy, &result );
+				}
+				else
+				{
+					simRun( src, &sjfPolicy, &config, NULL, &result );
+				}
+				calcAverages( result.waitTime, result.turnTime, result.count, &aveWait, &aveTurn );
+				psDestroy( src );
+				if( config.export != NULL && !exportClose( config.export ) )
+				{
+					printf( "Can not write file: %s\n", exportName );
+				}
+				config.export = NULL;
+
+				if( stream )
+				{
+					fileError = procStreamError( procStream, &errLine );
+					procStreamClose( procStream );
+				}
+				else
+				{
+					ptDestroy( procTable );
+				}
+				span = result.end - result.start;
+			}
+			else if( fileError == PROC_NO_ERROR && stream )
+			{
+				sjfSimStream( procStream, config.progress, &aveWait, &aveTurn );
+				fileError = procStreamError( procStream, &errLine );
+				procStreamClose( procStream );
+			}
+			else if( fileError == PROC_NO_ERROR )
+			{
+				sjfSimTable( procTable, &aveWait, &aveTurn );
+
+				/* Free our table of processes */
+				ptDestroy( procTable );
+			}
 
 			/* Check to see if an error occurred while reading file */
 			if( fileError == PROC_NO_OPEN )
@@ -42,21 +192,49 @@ int main( void )
 			}
 			else if( fileError == PROC_BAD_FORMAT )
 			{
-				printf( "File is not formatted properly!\n" );
+				printf( "File is not formatted properly! (line %lu)\n", (unsigned long)errLine );
+			}
+			else if( fileError == PROC_NOT_SORTED )
+			{
+				printf( "File is not in order of arrival! (line %lu)\n", (unsigned long)errLine );
 			}
 			else
 			{
-				double aveTurn, aveWait;
+				printf( "Average Turnaround: %f\nAverage Waiting: %f\n", aveTurn, aveWait );
 
-				/* Processes read successfully. Run simulation */
-				sjfSim( procList, &aveWait, &aveTurn );
+				/* Show how busy each CPU was over the whole simulation */
+				if( config.numCpus > 1 )
+				{
+					int i;
 
-				printf( "Average Turnaround: %f\nAverage Waiting: %f\n", aveTurn, aveWait );
+					for( i = 0; i < config.numCpus; i++ )
+					{
+						printf( "CPU %d Utilisation: %f%%\n", i + 1, span > 0 ? 100.0 * busy[i] / span : 0.0 );
+					}
+				}
+
+				/* Show how much of the CPUs' time went on switching */
+				if( config.dispatch > 0 || config.refill > 0 )
+				{
+					double utilisation, overhead;
+
+					utilisation = simUtilisation( &result, config.numCpus, &overhead );
+					printf( "Overhead: %lld (%f%% of CPU time)\nEffective Utilisation: %f%%\n",
+						(long long)result.overhead, 100.0 * overhead, 100.0 * utilisation );
+				}
+
+				if( showStats )
+				{
+					char stats[SIM_STATS_LEN];
+
+					simStatsFormat( &result.stats, stats );
+					printf( "Counters: %s\n", stats );
+				}
 			}
-			/* Free our list of processes */
-			listDestroyFree( procList );
 		}
 	} while( strcmp( fileName, "QUIT" ) != 0 );
 
+	free( busy );
+
 	return 0;
 }
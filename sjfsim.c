@@ -1,15 +1,6 @@
 #include "sjfsim.h"
-
-
-int sjfBurstCmp( const void *arg1, const void *arg2 )
-{
-	const struct sjfData *p1, *p2;
-
-	p1 = arg1;
-	p2 = arg2;
-
-	return cmp( p1->proc->burstTime, p2->proc->burstTime );
-}
+#include "PQueue.h"
+#include "ProcSource.h"
 
 
 int sjfCmp( const void *arg1, const void *arg2 )
@@ -33,82 +24,87 @@ int sjfCmp( const void *arg1, const void *arg2 )
 }
 
 
+/* Makes an empty shortest job first ready queue */
+static void *sjfCreate( size_t capacity, const struct simConfig *config )
+{
+	return pQueueCreate( capacity );
+}
+
+
+/* Frees a shortest job first ready queue */
+static void sjfDestroy( void *state )
+{
+	pQueueDestroy( state );
+}
+
+
+/* Adds a process to the ready queue. The job with the least time left
+ * comes out first, with equal times going in order of process number.
+ * Until a process has run this is its burst time */
+static void sjfEnqueue( void *state, const struct simJob *job )
+{
+	pQueueInsert( state, job->remaining, job->proc.pNo, job );
+}
+
+
+/* Takes the shortest job from the ready queue */
+static void sjfPickNext( void *state, struct simJob *outJob )
+{
+	pQueueExtractMin( state, outJob );
+}
+
+
+/* A picked job runs until it completes unless it is pre-empted */
+static simTime sjfQuantum( void *state, const struct simJob *job )
+{
+	return job->remaining;
+}
+
+
+/* An arriving job pre-empts the running job if it needs less time than the
+ * running job has left */
+static int srtfPreempt( void *state, const struct simJob *running, const struct simJob *arrived )
+{
+	return arrived->remaining < running->remaining;
+}
+
+
+const struct simPolicy sjfPolicy =
+{
+	sjfCreate,
+	sjfDestroy,
+	sjfEnqueue,
+	sjfPickNext,
+	sjfQuantum,
+	NULL
+};
+
+
+const struct simPolicy srtfPolicy =
+{
+	sjfCreate,
+	sjfDestroy,
+	sjfEnqueue,
+	sjfPickNext,
+	sjfQuantum,
+	srtfPreempt
+};
+
+
 void sjfSim( LList inProcList, double *outAveWait, double *outAveTurn )
 {
-	LList procList, rdyQueue;
-	struct sjfData *runningProc;
+	ProcSource src;
 	Gantt gantt;
-	int timer;
+	struct simConfig config;
+	struct simResult result;
 
 	assert( inProcList != NULL );
 	assert( outAveWait != NULL && outAveTurn != NULL );
 
-	/* Create the ready queue */
-	rdyQueue = listCreate();
-
-	/* Create a copy of inProcList so that we can sort it by arrival and
-	 * burst time */
-	procList = listCopy( inProcList );		
-	listSort( procList, sjfCmp );
-
-	/* Create our gantt chart. The start time will be the start time of the
-	 * first arrivaing process. Need to ensure that it will work if our
-	 * list size is 0 */
-	if( listSize( inProcList ) > 0 )
-	{
-		gantt = ganttCreate( ( (struct proc*)listGet( procList, 1 ) )->arrivalTime );
-	}
-	else
-	{
-		gantt = ganttCreate( 0 );
-	}
-
-	/* There is no currently running process and we are at time 0 */
-	runningProc = NULL;
-	timer = 0;
-	/* Terminate when both ready queue and list of processes is empty and when
-	 * there is no currently running process */
-	while( !( listSize( rdyQueue ) == 0 && listSize( procList ) == 0 && runningProc == NULL )  )
-	{
-		/* Add any arrived processes to the ready queue */
-		while( listSize( procList ) > 0 && ((struct proc*)listGet( procList, 1 ))->arrivalTime == timer )
-		{
-			struct sjfData *procData;
-			procData = malloc( sizeof( *procData ) );
-			procData->proc = (struct proc*)listRemove( procList, 1 );
-			procData->remaining = procData->proc->burstTime;
-			
-			/* Add process (with housekeeping data) to our ready queue */
-			listAdd( rdyQueue, procData, listSize( rdyQueue ) + 1 );
-			/* Resort our ready queue to make sure the shortest job is
-			 * first */
-			listSort( rdyQueue, sjfBurstCmp );
-		}
-
-		/* Check to see if a process is ready to run */
-		if( runningProc == NULL && listSize( rdyQueue ) > 0 )
-		{
-			runningProc = listRemove( rdyQueue, 1 );
-		}
-
-		/* Check to see whether process has finished running */
-		if( runningProc != NULL )
-		{
-			runningProc->remaining--;
-
-			/* Process's burst time has completed */
-			if( runningProc->remaining == 0 )
-			{
-				ganttAddBlock( gantt, runningProc->proc->pNo, runningProc->proc->burstTime );
-
-				/* Need to free here because we have already removed
-				 * from the ready queue */
-				free( runningProc );
-				runningProc = NULL;
-			}
-		}
-		timer++;
-	}
+	/* Sort a copy of inProcList by arrival and burst time and simulate it */
+	simConfigDefaults( &config, 0 );
+	src = psFromList( inProcList, sjfCmp );
+	simRun( src, &sjfPolicy, &config, &gantt, &result );
 
 	/* Ensure that list is not empty so as to avoid divide by zero errors */
 	if( listSize( inProcList ) > 0 )
@@ -122,7 +118,63 @@ void sjfSim( LList inProcList, double *outAveWait, double *outAveTurn )
 	}
 
 	/* Clean up our used memory */
-	listDestroy( procList );
-	listDestroyFree( rdyQueue );
+	psDestroy( src );
 	ganttDestroy( gantt );
 }
+
+
+void sjfSimMetrics( LList inProcList, double *outAveWait, double *outAveTurn )
+{
+	ProcSource src;
+	struct simConfig config;
+
+	assert( inProcList != NULL );
+
+	simConfigDefaults( &config, 0 );
+	src = psFromList( inProcList, sjfCmp );
+	simRunAverages( src, &sjfPolicy, &config, outAveWait, outAveTurn );
+	psDestroy( src );
+}
+
+
+void sjfSimTable( ProcTable table, double *outAveWait, double *outAveTurn )
+{
+	ProcSource src;
+	struct simConfig config;
+
+	assert( table != NULL );
+
+	simConfigDefaults( &config, 0 );
+	src = psFromTable( table );
+	simRunAverages( src, &sjfPolicy, &config, outAveWait, outAveTurn );
+	psDestroy( src );
+}
+
+
+void sjfSimStream( ProcStream stream, size_t progress, double *outAveWait, double *outAveTurn )
+{
+	ProcSource src;
+	struct simConfig config;
+
+	assert( stream != NULL );
+
+	simConfigDefaults( &config, 0 );
+	config.progress = progress;
+	src = psFromStream( stream );
+	simRunAverages( src, &sjfPolicy, &config, outAveWait, outAveTurn );
+	psDestroy( src );
+}
+
+
+void srtfSimTable( ProcTable table, double *outAveWait, double *outAveTurn )
+{
+	ProcSource src;
+	struct simConfig config;
+
+	assert( table != NULL );
+
+	simConfigDefaults( &config, 0 );
+	src = psFromTable( table );
+	simRunAverages( src, &srtfPolicy, &config, outAveWait, outAveTurn );
+	psDestroy( src );
+}
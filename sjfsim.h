@@ -13,36 +13,23 @@
 #include "common.h"
 #include "LList.h"
 #include "proc.h"
+#include "ProcTable.h"
+#include "ProcStream.h"
 #include "simcalc.h"
+#include "simengine.h"
 
 
-/* A small structure used to record shortest job
- * first housekeeping data for a process.
- * struct proc *proc - A pointer to the process's information.
- * int remaining - The remaining amount of time until all of the process's
- * 	burst time is exceeded.
- */
-struct sjfData
-{
-	struct proc *proc;
-	int remaining;
-};
+/* The shortest job first policy for simRun. Its ready queue is a PQueue
+ * keyed on the time each process has left, and a process runs to
+ * completion once picked. */
+extern const struct simPolicy sjfPolicy;
 
 
-/****
- *  sjfBurstCmp
- *  Description: A callback function used to sort the list of processes.
- *  	This function sorts ONLY by burst time. It is useful for sorting
- *  	our ready queue so that the shortest process is always at the start
- *  	of the queue.
- *
- *  const void *arg1 - A struct sjfData *
- *  const void *arg2 - A struct sjfData *
- *
- *  Returns -1 if arg1->proc->burstTime < arg2->proc->burstTime, 0 if equal,
- *  	1 otherwise.
- */
-int sjfBurstCmp( const void *arg1, const void *arg2 );
+/* The shortest remaining time first policy for simRun, the pre-emptive
+ * form of shortest job first. It shares the ready queue of sjfPolicy, but
+ * a process that arrives needing less time than the running process has
+ * left pre-empts it. */
+extern const struct simPolicy srtfPolicy;
 
 
 /****
@@ -64,7 +51,10 @@ int sjfCmp( const void *arg1, const void *arg2 );
 /****
  *  sjfSim
  *  Description: Performs a simulation of a shortest job first scheduling
- *  	algorithm on the list of processes.
+ *  	algorithm on the list of processes. As SJF is non-preemptive the clock
+ *  	jumps directly from one completion to the next, admitting all of the
+ *  	arrivals in between as a single batch. The running time therefore does
+ *  	not depend on the burst lengths.
  *
  *  LList inProcList - The list of processes to simulate SJF for. Must be non-null.
  *  double *outAveWait - A pointer to a double to hold the average waiting time
@@ -79,4 +69,66 @@ int sjfCmp( const void *arg1, const void *arg2 );
 void sjfSim( LList inProcList, double *outAveWait, double *outAveTurn );
 
 
+/****
+ *  sjfSimMetrics
+ *  Description: Performs the same simulation as sjfSim and produces the same
+ *  	averages, but never builds a gantt chart. Each process's waiting and
+ *  	turnaround times are accumulated as it completes, so nothing is
+ *  	allocated per process run.
+ *
+ *  The arguments and results are exactly as for sjfSim.
+ */
+void sjfSimMetrics( LList inProcList, double *outAveWait, double *outAveTurn );
+
+
+/****
+ *  sjfSimTable
+ *  Description: Performs the same simulation as sjfSimMetrics on the
+ *  	processes in a process table. A table that is already in order of
+ *  	arrival is read in place without being copied or sorted.
+ *
+ *  ProcTable table - The table of processes to simulate. Must be non-null.
+ *  	It is not modified.
+ *  double *outAveWait, double *outAveTurn - As for sjfSim.
+ *
+ *  Returns nothing. outAveWait and outAveTurn are set as for sjfSim.
+ */
+void sjfSimTable( ProcTable table, double *outAveWait, double *outAveTurn );
+
+
+/****
+ *  sjfSimStream
+ *  Description: Performs the same simulation as sjfSimMetrics on a stream
+ *  	of processes that is already in order of arrival. Each process is
+ *  	read from the file only when the clock reaches its arrival time and is
+ *  	forgotten as soon as it completes, so only the processes in the ready
+ *  	queue are ever held in memory.
+ *
+ *  ProcStream stream - The stream of processes to simulate. Must be
+ *  	non-null. If it ends early because of an error the averages cover
+ *  	only the processes read before the error, and procStreamError should
+ *  	be checked once the simulation returns.
+ *  size_t progress - How many processes complete between the running
+ *  	averages printed on stderr. Zero for none.
+ *  double *outAveWait, double *outAveTurn - As for sjfSim.
+ *
+ *  Returns nothing. outAveWait and outAveTurn are set as for sjfSim.
+ */
+void sjfSimStream( ProcStream stream, size_t progress, double *outAveWait, double *outAveTurn );
+
+
+/****
+ *  srtfSimTable
+ *  Description: Performs a shortest remaining time first simulation on the
+ *  	processes in a process table. The table is read as for sjfSimTable.
+ *
+ *  ProcTable table - The table of processes to simulate. Must be non-null.
+ *  	It is not modified.
+ *  double *outAveWait, double *outAveTurn - As for sjfSim.
+ *
+ *  Returns nothing. outAveWait and outAveTurn are set as for sjfSim.
+ */
+void srtfSimTable( ProcTable table, double *outAveWait, double *outAveTurn );
+
+
 #endif
@@ -0,0 +1,546 @@
+/* sweep.c
+ * Runs a grid of simulations: every workload file
+ * against every policy, round robin against every
+ * quantum in a list, and all of them against every
+ * number of CPUs and placement in a list, at a
+ * chosen cost of switching. Each workload is loaded
+ * once and shared by all of its runs, and the runs
+ * are spread over a work-stealing pool of threads.
+ * The results are written as one CSV table.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "../common.h"
+#include "../proc.h"
+#include "../rrsim.h"
+#include "../sjfsim.h"
+#include "../WorkPool.h"
+
+#define SWEEP_RR 0
+#define SWEEP_SJF 1
+#define SWEEP_SRTF 2
+#define SWEEP_NUM_POLICIES 3
+
+
+/* The names of the policies as given to -p and written to the table */
+static const char *policyNames[SWEEP_NUM_POLICIES] = { "rr", "sjf", "srtf" };
+/* The policies themselves, in the same order */
+static const struct simPolicy *policies[SWEEP_NUM_POLICIES] = { &rrPolicy, &sjfPolicy, &srtfPolicy };
+
+
+/* One simulation in the grid.
+ * fileName, table - The workload. The table is shared read-only by every
+ * 	run of the same workload.
+ * order - The table's processes sorted once by arrival, shared the same
+ * 	way, if the table was not already in order. NULL otherwise.
+ * policy - SWEEP_RR, SWEEP_SJF or SWEEP_SRTF.
+ * quantum - The quantum for round robin. Unused for the others.
+ * numCpus, placement - The CPUs to simulate and how processes are placed
+ * 	on them.
+ * dispatch, refill, cold - What switching processes costs.
+ * aveWait, aveTurn - The results.
+ * utilMean, utilMin, utilMax - The mean, least and greatest fraction of the
+ * 	time from the first arrival to the last completion that a CPU was busy.
+ * overhead - The fraction of the CPUs' time spent switching processes.
+ * seconds - How long the simulation took. */
+struct sweepRun
+{
+	const char *fileName;
+	ProcTable table;
+	const struct proc *order;
+	int policy;
+	int quantum;
+	int numCpus;
+	int placement;
+	int dispatch;
+	int refill;
+	int cold;
+	double aveWait;
+	double aveTurn;
+	double utilMean;
+	double utilMin;
+	double utilMax;
+	double overhead;
+	double seconds;
+};
+
+
+/****
+ *  sweepTask
+ *  Description: The task run by the pool for each point of the grid.
+ *
+ *  void *arg - The struct sweepRun to simulate. The results are stored
+ *  	in it.
+ *
+ *  Returns nothing.
+ */
+static void sweepTask( void *arg )
+{
+	struct sweepRun *run = arg;
+	struct timespec start, end;
+	struct simConfig config;
+	struct simResult result;
+	ProcSource src;
+	simTime *busy;
+	int i;
+
+	simConfigDefaults( &config, run->quantum );
+	config.numCpus = run->numCpus;
+	config.placement = run->placement;
+	config.dispatch = run->dispatch;
+	config.refill = run->refill;
+	config.cold = run->cold;
+	busy = malloc( run->numCpus * sizeof *busy );
+
+	clock_gettime( CLOCK_MONOTONIC, &start );
+	src = ( run->order != NULL ) ? psFromOrder( run->order, ptSize( run->table ) ) : psFromTable( run->table );
+	if( run->numCpus > 1 )
+	{
+		simRunSmp( src, policies[run->policy], &config, busy, &result );
+	}
+	else
+	{
+		/* The one CPU is busy for every process's burst, which is the
+		 * difference between the turnaround and waiting times */
+		simRun( src, policies[run->policy], &config, NULL, &result );
+		busy[0] = result.turnTime - result.waitTime;
+	}
+	calcAverages( result.waitTime, result.turnTime, result.count, &run->aveWait, &run->aveTurn );
+	simUtilisation( &result, run->numCpus, &run->overhead );
+	psDestroy( src );
+	clock_gettime( CLOCK_MONOTONIC, &end );
+
+	run->seconds = ( end.tv_sec - start.tv_sec ) + ( end.tv_nsec - start.tv_nsec ) / 1e9;
+
+	run->utilMean = 0.0;
+	run->utilMin = run->utilMax = ( result.end > result.start ) ? (double)busy[0] / ( result.end - result.start ) : 0.0;
+	for( i = 0; i < run->numCpus; i++ )
+	{
+		double util = ( result.end > result.start ) ? (double)busy[i] / ( result.end - result.start ) : 0.0;
+
+		run->utilMean += util / run->numCpus;
+		run->utilMin = ( util < run->utilMin ) ? util : run->utilMin;
+		run->utilMax = ( util > run->utilMax ) ? util : run->utilMax;
+	}
+	free( busy );
+}
+
+
+/****
+ *  sweepWriteName
+ *  Description: Writes a workload's name as a CSV field. A name holding a
+ *  	comma, a quote or a line break is quoted, with each quote doubled.
+ *
+ *  FILE *outFile - The table being written.
+ *  const char *name - The name.
+ *
+ *  Returns nothing.
+ */
+static void sweepWriteName( FILE *outFile, const char *name )
+{
+	if( strpbrk( name, ",\"\r\n" ) == NULL )
+	{
+		fputs( name, outFile );
+	}
+	else
+	{
+		fputc( '"', outFile );
+		for( ; *name != '\0'; name++ )
+		{
+			if( *name == '"' )
+			{
+				fputc( '"', outFile );
+			}
+			fputc( *name, outFile );
+		}
+		fputc( '"', outFile );
+	}
+}
+
+
+/****
+ *  sweepParseList
+ *  Description: Parses a list of numbers, such as quanta or numbers of
+ *  	CPUs, like "1-10,20,50-100:10". Each item is a single number, a
+ *  	range, or a range with a step.
+ *
+ *  const char *spec - The list.
+ *  int **outList - Where to place the array of numbers. It should be
+ *  	freed with free.
+ *  int *outNumList - Where to place the count of numbers.
+ *
+ *  Returns TRUE if the list was valid and every number is positive.
+ */
+static int sweepParseList( const char *spec, int **outList, int *outNumList )
+{
+	const char *pos = spec;
+	int *items = NULL;
+	int numItems = 0, capacity = 0;
+	int valid = TRUE;
+
+	while( valid && *pos != '\0' )
+	{
+		char *next;
+		long lo, hi, step = 1;
+
+		lo = strtol( pos, &next, 10 );
+		hi = lo;
+		valid = ( next != pos );
+		if( valid && *next == '-' )
+		{
+			pos = next + 1;
+			hi = strtol( pos, &next, 10 );
+			valid = ( next != pos );
+		}
+		if( valid && *next == ':' )
+		{
+			pos = next + 1;
+			step = strtol( pos, &next, 10 );
+			valid = ( next != pos );
+		}
+		valid = valid && lo > 0 && hi >= lo && hi <= 1000000000 && step > 0 &&
+			( *next == ',' || *next == '\0' );
+
+		for( ; valid && lo <= hi; lo += step )
+		{
+			if( numItems == capacity )
+			{
+				capacity = ( capacity > 0 ) ? 2 * capacity : 16;
+				items = realloc( items, capacity * sizeof *items );
+			}
+			items[numItems] = (int)lo;
+			numItems++;
+		}
+
+		pos = ( valid && *next == ',' ) ? next + 1 : next;
+	}
+
+	if( valid && numItems > 0 )
+	{
+		*outList = items;
+		*outNumList = numItems;
+	}
+	else
+	{
+		free( items );
+		valid = FALSE;
+	}
+
+	return valid;
+}
+
+
+/****
+ *  sweepParseNames
+ *  Description: Parses a list of names such as "rr,sjf".
+ *
+ *  const char *spec - The list.
+ *  const char **names, int numNames - The names that may be in the list.
+ *  int *outUse - Where to place TRUE or FALSE for each name.
+ *
+ *  Returns TRUE if every name in the list is known.
+ */
+static int sweepParseNames( const char *spec, const char **names, int numNames, int *outUse )
+{
+	const char *pos = spec;
+	int valid = TRUE;
+	int i;
+
+	for( i = 0; i < numNames; i++ )
+	{
+		outUse[i] = FALSE;
+	}
+
+	while( valid && *pos != '\0' )
+	{
+		size_t len = strcspn( pos, "," );
+
+		valid = FALSE;
+		for( i = 0; i < numNames; i++ )
+		{
+			if( len == strlen( names[i] ) && strncmp( pos, names[i], len ) == 0 )
+			{
+				outUse[i] = TRUE;
+				valid = TRUE;
+			}
+		}
+		pos += len;
+		if( *pos == ',' )
+		{
+			pos++;
+		}
+	}
+
+	return valid;
+}
+
+
+int main( int argc, char *argv[] )
+{
+	int *quanta = NULL;
+	int numQuanta = 0;
+	int *cpus = NULL;
+	int numCpuCounts = 0;
+	int usePolicy[SWEEP_NUM_POLICIES] = { TRUE, TRUE, FALSE };
+	int usePlacement[SIM_NUM_PLACEMENTS] = { TRUE, FALSE, FALSE };
+	const char *placementNames[SIM_NUM_PLACEMENTS];
+	int numWorkers = 0;
+	const char *outFileName = NULL;
+	struct simConfig costs;
+	int valid = TRUE;
+	int opt;
+	int error = 0;
+
+	for( opt = 0; opt < SIM_NUM_PLACEMENTS; opt++ )
+	{
+		placementNames[opt] = simPlacementName( opt );
+	}
+
+	/* Only the costs of switching are taken from here */
+	simConfigDefaults( &costs, 0 );
+
+	while( ( opt = getopt( argc, argv, "q:p:n:m:d:r:j:o:" ) ) != -1 )
+	{
+		if( opt == 'q' )
+		{
+			free( quanta );
+			quanta = NULL;
+			valid = valid && sweepParseList( optarg, &quanta, &numQuanta );
+		}
+		else if( opt == 'p' )
+		{
+			valid = valid && sweepParseNames( optarg, policyNames, SWEEP_NUM_POLICIES, usePolicy );
+		}
+		else if( opt == 'n' )
+		{
+			free( cpus );
+			cpus = NULL;
+			valid = valid && sweepParseList( optarg, &cpus, &numCpuCounts );
+		}
+		else if( opt == 'm' )
+		{
+			valid = valid && sweepParseNames( optarg, placementNames, SIM_NUM_PLACEMENTS, usePlacement );
+		}
+		else if( opt == 'd' )
+		{
+			costs.dispatch = atoi( optarg );
+			valid = valid && costs.dispatch >= 0;
+		}
+		else if( opt == 'r' )
+		{
+			valid = valid && sscanf( optarg, "%d,%d", &costs.refill, &costs.cold ) >= 1 &&
+				costs.refill >= 0 && costs.cold > 0;
+		}
+		else if( opt == 'j' )
+		{
+			numWorkers = atoi( optarg );
+		}
+		else if( opt == 'o' )
+		{
+			outFileName = optarg;
+		}
+		else
+		{
+			valid = FALSE;
+		}
+	}
+
+	if( !valid || optind == argc )
+	{
+		fprintf( stderr, "Usage: %s [-q quanta] [-p rr,sjf,srtf] [-n cpus] [-m global,steal,push]\n"
+			"       [-d latency] [-r refill[,cold]] [-j workers] [-o out.csv] file...\n"
+			"  quanta and cpus are lists such as 1-10,20,50-100:10. Without -q\n"
+			"  each file's own quantum is used. Without -n one CPU is simulated.\n"
+			"  -d and -r charge every run for switching processes.\n", argv[0] );
+		error = 1;
+	}
+	else
+	{
+		int numFiles = argc - optind;
+		ProcTable *tables;
+		struct proc **orders;
+		struct sweepRun *runs = NULL;
+		size_t numRuns = 0, maxRuns = 1, r;
+		size_t dims[5];
+		WorkPool pool = NULL;
+		FILE *outFile = stdout;
+		int i, j, k;
+
+		/* Load every workload once, up front, and sort it once if it is
+		 * not in order. All of its runs share it */
+		tables = malloc( numFiles * sizeof *tables );
+		orders = malloc( numFiles * sizeof *orders );
+		for( i = 0; i < numFiles; i++ )
+		{
+			int fileError;
+			size_t errLine;
+
+			fileError = procReadTableParallel( argv[optind + i], 0, &tables[i], &errLine );
+			if( fileError == PROC_NO_OPEN )
+			{
+				fprintf( stderr, "Can not open file: %s\n", argv[optind + i] );
+			}
+			else if( fileError == PROC_BAD_FORMAT )
+			{
+				fprintf( stderr, "File is not formatted properly: %s (line %lu)\n", argv[optind + i], (unsigned long)errLine );
+			}
+			/* Round robin with the file's own quantum needs it to be
+			 * positive */
+			else if( fileError == PROC_NO_ERROR && usePolicy[SWEEP_RR] && numQuanta == 0 && ptQuantum( tables[i] ) <= 0 )
+			{
+				fprintf( stderr, "Quantum is not positive: %s\n", argv[optind + i] );
+				ptDestroy( tables[i] );
+				fileError = PROC_BAD_FORMAT;
+			}
+
+			/* A workload that will not load is left out of the grid */
+			if( fileError != PROC_NO_ERROR )
+			{
+				tables[i] = NULL;
+				error = 1;
+			}
+			orders[i] = ( tables[i] != NULL && !ptSorted( tables[i] ) ) ? psOrderTable( tables[i] ) : NULL;
+		}
+
+		/* Without -n just the one CPU is simulated */
+		if( cpus == NULL )
+		{
+			cpus = malloc( sizeof *cpus );
+			cpus[0] = 1;
+			numCpuCounts = 1;
+		}
+
+		/* Make room for the largest grid the lists could give, making
+		 * sure the size does not overflow */
+		dims[0] = numFiles;
+		dims[1] = ( numQuanta > 0 ) ? numQuanta : 1;
+		dims[2] = SWEEP_NUM_POLICIES;
+		dims[3] = numCpuCounts;
+		dims[4] = SIM_NUM_PLACEMENTS;
+		for( r = 0; maxRuns > 0 && r < sizeof dims / sizeof *dims; r++ )
+		{
+			maxRuns = ( maxRuns <= SIZE_MAX / sizeof *runs / dims[r] ) ? maxRuns * dims[r] : 0;
+		}
+		if( maxRuns > 0 )
+		{
+			runs = malloc( maxRuns * sizeof *runs );
+		}
+		if( runs == NULL )
+		{
+			fprintf( stderr, "Too many runs in the grid!\n" );
+			error = 1;
+		}
+
+		/* Lay out the grid. Placement only matters with more than one CPU */
+		for( i = 0; runs != NULL && i < numFiles; i++ )
+		{
+			for( j = 0; tables[i] != NULL && j < SWEEP_NUM_POLICIES; j++ )
+			{
+				int numPoints = ( j == SWEEP_RR && numQuanta > 0 ) ? numQuanta : 1;
+
+				for( k = 0; usePolicy[j] && k < numPoints; k++ )
+				{
+					int c, m;
+
+					for( c = 0; c < numCpuCounts; c++ )
+					{
+						for( m = 0; m < SIM_NUM_PLACEMENTS; m++ )
+						{
+							if( cpus[c] > 1 ? usePlacement[m] : m == SIM_PLACE_GLOBAL )
+							{
+								runs[numRuns].fileName = argv[optind + i];
+								runs[numRuns].table = tables[i];
+								runs[numRuns].order = orders[i];
+								runs[numRuns].policy = j;
+								runs[numRuns].quantum = ( numQuanta > 0 ) ? quanta[k] : ptQuantum( tables[i] );
+								runs[numRuns].numCpus = cpus[c];
+								runs[numRuns].placement = m;
+								runs[numRuns].dispatch = costs.dispatch;
+								runs[numRuns].refill = costs.refill;
+								runs[numRuns].cold = costs.cold;
+								numRuns++;
+							}
+						}
+					}
+				}
+			}
+		}
+
+		if( runs != NULL )
+		{
+			pool = workPoolCreate( numWorkers );
+			if( outFileName != NULL )
+			{
+				outFile = fopen( outFileName, "w" );
+			}
+		}
+
+		if( runs == NULL )
+		{
+			/* Already reported */
+		}
+		else if( pool == NULL )
+		{
+			fprintf( stderr, "Could not create worker threads!\n" );
+			error = 1;
+		}
+		else if( outFile == NULL )
+		{
+			fprintf( stderr, "Can not open file: %s\n", outFileName );
+			error = 1;
+		}
+		else
+		{
+			for( r = 0; r < numRuns; r++ )
+			{
+				workPoolSubmit( pool, sweepTask, &runs[r] );
+			}
+			workPoolWait( pool );
+
+			/* Write the table in grid order however the runs finished */
+			fprintf( outFile, "workload,policy,quantum,cpus,placement,processes,ave_wait,ave_turn,util_mean,util_min,util_max,overhead,seconds\n" );
+			for( r = 0; r < numRuns; r++ )
+			{
+				sweepWriteName( outFile, runs[r].fileName );
+				fprintf( outFile, ",%s,", policyNames[runs[r].policy] );
+				if( runs[r].policy == SWEEP_RR )
+				{
+					fprintf( outFile, "%d", runs[r].quantum );
+				}
+				fprintf( outFile, ",%d,%s,%lu,%f,%f,%f,%f,%f,%f,%f\n", runs[r].numCpus, simPlacementName( runs[r].placement ),
+					(unsigned long)ptSize( runs[r].table ), runs[r].aveWait, runs[r].aveTurn,
+					runs[r].utilMean, runs[r].utilMin, runs[r].utilMax, runs[r].overhead, runs[r].seconds );
+			}
+		}
+
+		/* Clean up */
+		if( pool != NULL )
+		{
+			workPoolDestroy( pool );
+		}
+		if( outFile != NULL && outFile != stdout )
+		{
+			fclose( outFile );
+		}
+		for( i = 0; i < numFiles; i++ )
+		{
+			if( tables[i] != NULL )
+			{
+				ptDestroy( tables[i] );
+			}
+			free( orders[i] );
+		}
+		free( tables );
+		free( orders );
+		free( runs );
+	}
+
+	free( quanta );
+	free( cpus );
+
+	return error;
+}